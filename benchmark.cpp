@@ -0,0 +1,274 @@
+#include "graph.h"
+#include "graph_benchmark.h"
+#include "graph_dumb_vector.h"
+#include "graph_generators.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+using namespace std;
+
+/// @brief Options of one benchmark run, see usage()
+struct benchmark_options {
+  vector<string> graphs = {"set", "vector"};
+  vector<string> generators = {"mesh", "random"};
+  vector<size_t> sizes = {400, 1600};
+  unsigned phases = all_benchmark_phases;
+  size_t warmup = 1;
+  size_t reps = 5;
+  unsigned seed = 0;
+  string format = "table";
+  string output;
+  string baseline;
+  double threshold = 0.1;
+  bool counters = false;
+};
+
+void usage() {
+  cerr << "Run program like: ./benchmark.o [--option=value ...]\n"
+    "  --graphs=LIST      set, heap, vector, soa, sorted (default set,vector)\n"
+    "  --generators=LIST  complete, mesh, random, rmat, gnp (default mesh,random)\n"
+    "  --sizes=LIST       graph sizes (default 400,1600)\n"
+    "  --phases=LIST      create, bfs, dfs, erase (default all)\n"
+    "  --warmup=N         untimed runs per configuration (default 1)\n"
+    "  --reps=N           timed runs per configuration (default 5)\n"
+    "  --seed=N           srand() seed of every run (default 0)\n"
+    "  --format=F         table, csv or json (default table)\n"
+    "  --output=FILE      write the results to FILE instead of stdout\n"
+    "  --baseline=FILE    compare medians with a CSV file written by --format=csv\n"
+    "  --threshold=X      flag slowdowns above X, 0.1 = 10% (default 0.1)\n"
+    "  --counters=1       count cycles, instructions, LLC and branch misses and\n"
+    "                     page faults per phase where perf_event_open allows\n"
+    "Example: ./benchmark.o --graphs=set --sizes=1000,4000 --format=csv --output=base.csv\n"
+    "         ./benchmark.o --graphs=set --sizes=1000,4000 --baseline=base.csv" << endl;
+}
+
+/// @brief split a comma separated list
+vector<string> split_list(const string& s) {
+  vector<string> items;
+  istringstream is(s);
+  string item;
+  while(getline(is, item, ','))
+    if(!item.empty())
+      items.push_back(item);
+  return items;
+}
+
+/// @brief parse --key=value arguments into o. Returns false on any error.
+bool parse_options(int argc, char** argv, benchmark_options& o) {
+  for(int a = 1; a < argc; ++a) {
+    string arg = argv[a];
+    size_t eq = arg.find('=');
+    if(arg == "--help")
+      return false;
+    if(arg.compare(0, 2, "--") != 0 || eq == string::npos) {
+      cerr << "Error. Bad argument " << arg << endl;
+      return false;
+    }
+    string key = arg.substr(2, eq - 2), value = arg.substr(eq + 1);
+    if(key == "graphs")
+      o.graphs = split_list(value);
+    else if(key == "generators")
+      o.generators = split_list(value);
+    else if(key == "sizes") {
+      o.sizes.clear();
+      for(auto& s : split_list(value))
+        o.sizes.push_back(strtoull(s.c_str(), nullptr, 10));
+    }
+    else if(key == "phases") {
+      o.phases = 0;
+      for(auto& s : split_list(value)) {
+        benchmark_phase p;
+        if(!parse_phase(s, p)) {
+          cerr << "Error. Unknown phase " << s << endl;
+          return false;
+        }
+        o.phases |= phase_bit(p);
+      }
+    }
+    else if(key == "warmup")
+      o.warmup = strtoull(value.c_str(), nullptr, 10);
+    else if(key == "reps")
+      o.reps = strtoull(value.c_str(), nullptr, 10);
+    else if(key == "seed")
+      o.seed = strtoul(value.c_str(), nullptr, 10);
+    else if(key == "format")
+      o.format = value;
+    else if(key == "output")
+      o.output = value;
+    else if(key == "baseline")
+      o.baseline = value;
+    else if(key == "threshold")
+      o.threshold = strtod(value.c_str(), nullptr);
+    else if(key == "counters")
+      o.counters = value != "0";
+    else {
+      cerr << "Error. Unknown option " << key << endl;
+      return false;
+    }
+  }
+  if(o.format != "table" && o.format != "csv" && o.format != "json") {
+    cerr << "Error. Unknown format " << o.format << endl;
+    return false;
+  }
+  if(o.reps == 0 || o.phases == 0) {
+    cerr << "Error. Nothing to time" << endl;
+    return false;
+  }
+  return true;
+}
+
+/// @brief Median of each event over readings, valid if it was counted in all
+perf_reading median_reading(const vector<perf_reading>& readings) {
+  perf_reading m;
+  for(int e = 0; e < num_perf_events; ++e) {
+    vector<uint64_t> c;
+    for(auto& r : readings)
+      if(r.valid[e])
+        c.push_back(r.count[e]);
+    if(c.empty() || c.size() != readings.size())
+      continue;
+    nth_element(c.begin(), c.begin() + c.size() / 2, c.end());
+    m.valid[e] = true;
+    m.count[e] = c[c.size() / 2];
+  }
+  return m;
+}
+
+/// @brief Run one configuration warmup + reps times, each on a freshly
+///        generated graph from the same seed, and append one record per
+///        selected phase
+template<typename graph_id, typename Initializer>
+void run_configuration(Initializer init, const string& graph_name,
+    const string& generator, size_t n, const benchmark_options& o,
+    vector<benchmark_record>& records) {
+  vector<vector<double>> samples(num_benchmark_phases);
+  vector<vector<perf_reading>> counts(num_benchmark_phases);
+  double seconds[num_benchmark_phases];
+  perf_reading readings[num_benchmark_phases];
+  perf_counters counters;
+  reset_peak_rss();
+  for(size_t run = 0; run < o.warmup + o.reps; ++run) {
+    srand(o.seed);
+    time_phases<graph_id>(init, n, o.phases, seconds,
+        o.counters ? &counters : nullptr, readings);
+    if(run >= o.warmup)
+      for(int p = 0; p < num_benchmark_phases; ++p)
+        if(o.phases & phase_bit(benchmark_phase(p))) {
+          samples[p].push_back(seconds[p]);
+          counts[p].push_back(readings[p]);
+        }
+  }
+  size_t rss = peak_rss_bytes();
+
+  for(int p = 0; p < num_benchmark_phases; ++p)
+    if(o.phases & phase_bit(benchmark_phase(p))) {
+      benchmark_record r;
+      r.graph = graph_name;
+      r.generator = generator;
+      r.size = n;
+      r.phase = phase_name(benchmark_phase(p));
+      r.stats = summarize(samples[p]);
+      r.peak_rss = rss;
+      r.counters = median_reading(counts[p]);
+      records.push_back(r);
+    }
+}
+
+/// @brief Run every selected generator and size on one graph type
+template<typename graph_id>
+void run_graph(const string& graph_name, const benchmark_options& o,
+    vector<benchmark_record>& records) {
+  for(auto& generator : o.generators)
+    for(size_t n : o.sizes) {
+      cerr << "Running " << graph_name << " " << generator << " " << n << endl;
+      if(generator == "complete")
+        run_configuration<graph_id>(initialize_complete_graph<graph_id>,
+            graph_name, generator, n, o, records);
+      else if(generator == "mesh")
+        run_configuration<graph_id>(initialize_mesh_graph<graph_id>,
+            graph_name, generator, n, o, records);
+      else if(generator == "random")
+        run_configuration<graph_id>(initialize_random_graph<graph_id>,
+            graph_name, generator, n, o, records);
+      else if(generator == "rmat")
+        run_configuration<graph_id>(initialize_rmat_graph<graph_id>,
+            graph_name, generator, n, o, records);
+      else if(generator == "gnp")
+        run_configuration<graph_id>(initialize_gnp_graph<graph_id>,
+            graph_name, generator, n, o, records);
+      else
+        cerr << "Skipping unknown generator " << generator << endl;
+    }
+}
+
+/// @brief Main function: run the selected benchmarks, write the results and
+///        compare them against a baseline. Exits with 2 if a phase got slower
+///        than the threshold allows.
+int main(int argc, char** argv) {
+  benchmark_options o;
+  if(!parse_options(argc, argv, o)) {
+    usage();
+    exit(-1);
+  }
+
+  vector<benchmark_record> baseline;
+  if(!o.baseline.empty()) {
+    ifstream is(o.baseline);
+    if(!read_baseline(is, baseline)) {
+      cerr << "Error. Cannot read baseline " << o.baseline << endl;
+      exit(-1);
+    }
+  }
+
+  if(o.counters && !perf_counters().available())
+    cerr << "Performance counters unavailable (perf_event_open failed), timing only" << endl;
+
+  vector<benchmark_record> records;
+  for(auto& g : o.graphs) {
+    if(g == "set")
+      run_graph<graph<int, double>>(g, o, records);
+    else if(g == "heap")
+      run_graph<graph<int, double, heap_arena>>(g, o, records);
+    else if(g == "vector")
+      run_graph<graph_vector<int, double>>(g, o, records);
+    else if(g == "soa")
+      run_graph<graph_vector<int, double, vector_soa>>(g, o, records);
+    else if(g == "sorted")
+      run_graph<graph_vector<int, double, vector_sorted>>(g, o, records);
+    else
+      cerr << "Skipping unknown graph type " << g << endl;
+  }
+
+  ofstream file;
+  if(!o.output.empty()) {
+    file.open(o.output);
+    if(!file) {
+      cerr << "Error. Cannot write " << o.output << endl;
+      exit(-1);
+    }
+  }
+  ostream& os = o.output.empty() ? cout : file;
+  if(o.format == "csv")
+    write_csv(os, records);
+  else if(o.format == "json")
+    write_json(os, records);
+  else
+    write_table(os, records);
+
+  if(!o.baseline.empty()) {
+    //keep stdout parseable when the results went there
+    ostream& report = o.output.empty() && o.format != "table" ? cerr : cout;
+    report << "\nComparison with " << o.baseline << " (threshold "
+      << o.threshold * 100 << "%):" << endl;
+    size_t slowdowns = compare_to_baseline(records, baseline, o.threshold, report);
+    report << slowdowns << " slowdown(s)" << endl;
+    if(slowdowns)
+      return 2;
+  }
+  return 0;
+}
@@ -6,18 +6,31 @@
 #include <utility>
 #include <algorithm>
 #include <memory>
-#include <unordered_set>
 #include <set>
-// Uncomment if using unordered_set to store edges with boost hash function
-//#include <boost/functional/hash.hpp>
+#include <vector>
+
+#include "graph_arena.h"
+#include "graph_hash_set.h"
+#include "graph_slot_map.h"
+
+// Edges and adjacency lists are indexed by an open-addressing hash set keyed
+// on the edge descriptor. Define GRAPH_EDGE_SET to use std::set (balanced
+// binary search tree) instead, e.g. to compare the two in timing.cpp.
+//#define GRAPH_EDGE_SET
 
 
 
 ////////////////////////////////////////////////////////////////////////////////
 /// A generic adjacency-list graph where each vertex stores a VertexProperty and
 /// each edge stores an EdgeProperty.
+///
+/// Vertex and edge objects, and the nodes of every internal container, are
+/// allocated from an Arena owned by the graph (see graph_arena.h). The default
+/// slab_arena packs nodes into large slabs and reuses erased nodes; heap_arena
+/// can be plugged in instead to allocate each node from the global heap.
 ////////////////////////////////////////////////////////////////////////////////
-template<typename VertexProperty, typename EdgeProperty>
+template<typename VertexProperty, typename EdgeProperty,
+         typename Arena = slab_arena>
 class graph {
 
   // The vertex and edge classes are forward-declared to allow their use in the
@@ -26,10 +39,7 @@ class graph {
   class vertex;
   class edge;
   
-  struct vertex_hash;
-  struct edge_hash;
-  struct vertex_eq;
-  struct edge_eq;
+  struct edge_key;
   struct edge_comp;
 
   public:
@@ -42,19 +52,38 @@ class graph {
     /// Unique edge identifier represents pair of vertex descriptors
     typedef std::pair<size_t, size_t> edge_descriptor;
 
+    /// Property types, e.g. to build batches for insert_vertices()
+    typedef VertexProperty vertex_property;
+    typedef EdgeProperty edge_property;
+
+    /// An edge to be added by insert_edges(): its descriptor and property
+    typedef std::pair<edge_descriptor, EdgeProperty> edge_value;
+
     ///@brief A container for the vertices. It should contain "vertex*" or
-    ///      shared_ptr<vertex>.
-    typedef std::unordered_set<vertex*, vertex_hash, vertex_eq> MyVertexContainer;
+    ///      shared_ptr<vertex>. Vertices are kept in a slot_map indexed by
+    ///      vertex_descriptor, so lookups are a single array access and
+    ///      iteration is in descriptor order.
+    typedef slot_map<vertex, arena_allocator<vertex*, counting_arena<Arena>>> MyVertexContainer;
 
+#ifndef GRAPH_EDGE_SET
     ///@brief A container for the edges. It should contain "edge*" or
     ///      shared_ptr<edge>.
-    //typedef std::unordered_set<edge*, edge_hash, edge_eq> MyEdgeContainer;
-	typedef std::set<edge*, edge_comp> MyEdgeContainer;
+    typedef open_hash_set<edge, edge_descriptor, edge_key, pair_hash,
+            arena_allocator<edge*, counting_arena<Arena>>> MyEdgeContainer;
 
     ///@brief A container for the adjacency lists. It should contain
     ///      "edge*" or shared_ptr<edge>.
-    //typedef std::unordered_set<edge*, edge_hash, edge_eq> MyAdjEdgeContainer;
-	typedef std::set<edge*, edge_comp> MyAdjEdgeContainer;
+    typedef open_hash_set<edge, edge_descriptor, edge_key, pair_hash,
+            arena_allocator<edge*, counting_arena<Arena>>> MyAdjEdgeContainer;
+#else
+    ///@brief A container for the edges. It should contain "edge*" or
+    ///      shared_ptr<edge>.
+	typedef std::set<edge*, edge_comp, arena_allocator<edge*, counting_arena<Arena>>> MyEdgeContainer;
+
+    ///@brief A container for the adjacency lists. It should contain
+    ///      "edge*" or shared_ptr<edge>.
+	typedef std::set<edge*, edge_comp, arena_allocator<edge*, counting_arena<Arena>>> MyAdjEdgeContainer;
+#endif
 	
 	// Vertex iterators
     typedef typename MyVertexContainer::iterator vertex_iterator;
@@ -71,7 +100,10 @@ class graph {
     // Required graph operations
 
     ///@brief Constructor/destructor
-    graph() : m_max_vd(0) { }
+    graph() : m_vertex_arena(&m_arena), m_edge_arena(&m_arena),
+      m_adjacency_arena(&m_arena), m_max_vd(0),
+      m_vertices(arena_allocator<vertex*, counting_arena<Arena>>(&m_vertex_arena)),
+      m_edges(arena_allocator<edge*, counting_arena<Arena>>(&m_edge_arena)) { }
 
     ~graph() {
         clear();
@@ -97,15 +129,22 @@ class graph {
     size_t num_edges() const {return m_edges.size();}
 
     vertex_iterator find_vertex(vertex_descriptor vd) {
-      vertex v(vd, VertexProperty());
-      return m_vertices.find(&v);
+      return m_vertices.find(vd);
     }
 
     const_vertex_iterator find_vertex(vertex_descriptor vd) const {
-      vertex v(vd, VertexProperty());
-      return m_vertices.find(&v);
+      return m_vertices.find(vd);
     }
 
+#ifndef GRAPH_EDGE_SET
+    edge_iterator find_edge(edge_descriptor ed) {
+      return m_edges.find(ed);
+    }
+
+    const_edge_iterator find_edge(edge_descriptor ed) const {
+      return m_edges.find(ed);
+    }
+#else
     edge_iterator find_edge(edge_descriptor ed) {
       edge e(ed.first, ed.second, EdgeProperty());
       return m_edges.find(&e);
@@ -115,14 +154,15 @@ class graph {
       edge e(ed.first, ed.second, EdgeProperty());
       return m_edges.find(&e);
     }
+#endif
 
     ///@todo Define modifiers
     vertex_descriptor insert_vertex(const VertexProperty& vp){ 
 
       //construct vertex obj and assign it to appropriate var type
-	  auto ins_vert = new vertex(m_max_vd, vp);
-    //insert that into the unordered set that contains all vertices 
-    m_vertices.insert(ins_vert);
+	  auto ins_vert = create<vertex>(m_max_vd, vp, &m_adjacency_arena);
+    //insert that into the slot of the slot map that belongs to its descriptor
+    m_vertices.insert(m_max_vd, ins_vert);
     //add the incrementation to the return value to insure the next insertion gets its unique 
     //vertex descriptor...
 	  return m_max_vd++;
@@ -131,7 +171,7 @@ class graph {
         const EdgeProperty& ep){
 
           //create edge obj with given passed parameters and assign to appropriate var
-    auto ins_edg = new edge(sd, td, ep);
+    auto ins_edg = create<edge>(sd, td, ep);
     
     //insert the given obj into the set that contains all edges 
     m_edges.insert(ins_edg);
@@ -139,12 +179,12 @@ class graph {
     //use find_vertex() so find vertex with given descriptor and assign it to
     //appropriate var. Important since this represents the vertex that is one side of the edge 
     //being inserted  
-    auto src_v = find_vertex(sd);
+    auto src_v = m_vertices.get(sd);
     
     //Now, since we have source vertex we dereference the vertex of interest 
     //and insert the given edge into that particular vertex's outgoing edge container. 
     //In this case, its an outgoing edge since the vertex of interest is assummed to be a source vertex.
-    (*src_v)->m_out_edges.insert(ins_edg);
+    src_v->m_out_edges.insert(ins_edg);
     
     //Now, we essentially do the same thing but for the target destination vertex
     //since, inserting an edge is going to be connected with 2 vertices 
@@ -152,12 +192,12 @@ class graph {
     //use find_vertex() so find vertex with given descriptor and assign it to
     //appropriate var. Important since this represents the vertex that is the other side of the edge 
     //being inserted 
-    auto targ_v = find_vertex(td);
+    auto targ_v = m_vertices.get(td);
 
     //Now, since we have target vertex we dereference the vertex of interest 
     //and insert the given edge into that particular vertex's incoming edge container. 
     //In this case, its an incoming edge since the vertex of interest is assummed to be a target vertex.
-    (*targ_v)->m_in_edges.insert(ins_edg);
+    targ_v->m_in_edges.insert(ins_edg);
 		return std::make_pair(sd, td);	
 	}
     void insert_edge_undirected(vertex_descriptor sd, vertex_descriptor td,
@@ -174,104 +214,202 @@ class graph {
            //essentially making a undirected edge
 			
 	}
+
+    ///@brief Insert a range of VertexProperty values. The new vertices get
+    ///       consecutive descriptors; returns the first one.
+    template<typename InputIterator>
+    vertex_descriptor insert_vertices(InputIterator first, InputIterator last) {
+      vertex_descriptor start = m_max_vd;
+      for(; first != last; ++first) {
+        m_vertices.insert(m_max_vd,
+            create<vertex>(m_max_vd, *first, &m_adjacency_arena));
+        ++m_max_vd;
+      }
+      return start;
+    }
+
+    ///@brief Insert a range of edge_value. The batch is sorted by descriptor
+    ///       once; repeated descriptors keep their first occurrence, and edges
+    ///       already in the graph or with a missing endpoint are skipped. The
+    ///       edge set and every touched adjacency list are then sized for the
+    ///       whole batch and filled in source order, so each list is built in
+    ///       one run instead of one probe sequence per insert_edge() call.
+    ///       Returns the number of edges inserted.
+    template<typename InputIterator>
+    size_t insert_edges(InputIterator first, InputIterator last) {
+      std::vector<edge_value> batch(first, last);
+      std::stable_sort(batch.begin(), batch.end(),
+          [](const edge_value& a, const edge_value& b) {return a.first < b.first;});
+
+      //compact the batch to the edges that will be inserted
+      size_t kept = 0;
+      for(size_t i = 0; i < batch.size(); ++i) {
+        const edge_descriptor& ed = batch[i].first;
+        if((kept > 0 && batch[kept - 1].first == ed) ||
+            !m_vertices.get(ed.first) || !m_vertices.get(ed.second) ||
+            find_edge(ed) != edges_end())
+          continue;
+        if(kept != i)
+          batch[kept] = std::move(batch[i]);
+        ++kept;
+      }
+      batch.erase(batch.begin() + kept, batch.end());
+
+#ifndef GRAPH_EDGE_SET
+      //size only the touched lists: the batch is sorted by source, so each
+      //source's additions are one run; targets are counted the same way
+      //after sorting them
+      m_edges.reserve(m_edges.size() + kept);
+      std::vector<vertex_descriptor> targets;
+      targets.reserve(kept);
+      for(size_t i = 0, j; i < kept; i = j) {
+        for(j = i; j < kept && batch[j].first.first == batch[i].first.first; ++j)
+          targets.push_back(batch[j].first.second);
+        vertex* v = m_vertices.get(batch[i].first.first);
+        v->m_out_edges.reserve(v->m_out_edges.size() + (j - i));
+      }
+      std::sort(targets.begin(), targets.end());
+      for(size_t i = 0, j; i < kept; i = j) {
+        for(j = i; j < kept && targets[j] == targets[i]; ++j) {}
+        vertex* v = m_vertices.get(targets[i]);
+        v->m_in_edges.reserve(v->m_in_edges.size() + (j - i));
+      }
+#endif
+
+      //descriptors arrive in increasing order, so with std::set the end()
+      //hint makes every insertion an append; out- and in-lists of a vertex
+      //are likewise filled in increasing order
+      for(auto& ev : batch) {
+        edge* e = create<edge>(ev.first.first, ev.first.second, ev.second);
+        m_edges.insert(m_edges.end(), e);
+        vertex* src_v = m_vertices.get(ev.first.first);
+        vertex* targ_v = m_vertices.get(ev.first.second);
+        src_v->m_out_edges.insert(src_v->m_out_edges.end(), e);
+        targ_v->m_in_edges.insert(targ_v->m_in_edges.end(), e);
+      }
+      return kept;
+    }
     void erase_vertex(vertex_descriptor vd){
 
-      //use find_vertex() so find vertex with given descriptor and assign it to
-      //appropriate var type.
-        auto erase_v = find_vertex(vd);
-
-        //checking if passed vertex was indeed found from our prev line...
-        if (erase_v != vertices_end()) {
-      
-
-       //loop over each outgoin edge in container associated with the 
-       //vertex that was passed to the function and
-       //assign it var of appropriate type so we 
-       //can perform necessary erase function on it. It will erase each of 
-       // the vertex's 
-       //associated outgoing edges and erase the outgoing edge from outgoing edge container
-       //and erase incoming edge from incoming edge container
-        for (auto erase_out_edg : (*erase_v)->m_out_edges) {
-          
-            erase_edge(erase_out_edg->descriptor());
-        }
-
-        delete *erase_v;
-
-      //erase vertex from unordered set that contains all the vertices....
-        m_vertices.erase(erase_v);
-
-        }
-		
+      //look the vertex up once; every incident edge is reached through its
+      //own adjacency lists, so the work is proportional to its degree
+      vertex* erase_v = m_vertices.get(vd);
+      if (!erase_v)
+        return;
+
+      //incoming edges: unlink each from its source's outgoing list and from
+      //the edge index. Self-loops are left to the outgoing pass below, which
+      //sees them too.
+      for (auto erase_in_edg : erase_v->m_in_edges) {
+        if (erase_in_edg->source() == vd)
+          continue;
+        m_vertices.get(erase_in_edg->source())->m_out_edges.erase(erase_in_edg);
+        m_edges.erase(erase_in_edg);
+        destroy(erase_in_edg);
+      }
+
+      //outgoing edges: unlink each from its target's incoming list (unless the
+      //target is this vertex, whose lists go away with it) and the edge index
+      for (auto erase_out_edg : erase_v->m_out_edges) {
+        if (erase_out_edg->target() != vd)
+          m_vertices.get(erase_out_edg->target())->m_in_edges.erase(erase_out_edg);
+        m_edges.erase(erase_out_edg);
+        destroy(erase_out_edg);
+      }
+
+      destroy(erase_v);
+
+      //tombstone the vertex's slot in the slot map that contains all the vertices....
+      m_vertices.erase(vd);
 	}
     void erase_edge(edge_descriptor ed){
 
       //find the edge of interest that was passed that we wish to erase and assign to var of appropriate type 
       auto erase_edg = find_edge(ed);
 
-
-
       //if the edge we looked for that was passed to the function was found...
       if (erase_edg != edges_end()) {
+        edge* e = *erase_edg;
 
-
-        //we remember that every time we inserted an edge we created a pair between the source and target vertices
-        //associated with that particular inserted edge as from insert_edge()... 
-        //so now we can correctly identify the vertices 
-        //among the edge we wish to erase from the graph. And we find them using the 
-        //find_vertex() function to do so. 
-
-        auto src_v = find_vertex(ed.first);
-        auto targ_v = find_vertex(ed.second);
-
-        //if the source and target vertices associated with the edge we wish to 
-        //erase were indeed found ...
-        if (src_v != vertices_end() && targ_v != vertices_end()) {
-
-        //search for erase_edg in outgoing edge container (for source vertex) and incoming 
-        //edge container (for the target vertex)
-        //and they should exists since when we inserted an edge ... we also inserted
-        //the edge in the source and target vertices outgoing and incoming edge container
-        //respectively as well.
-        auto erase_src_edg = find((*src_v)->m_out_edges.begin(), (*src_v)->m_out_edges.end(), *erase_edg);
-        auto erase_targ_edg = find((*targ_v)->m_in_edges.begin(), (*targ_v)->m_in_edges.end(), *erase_edg);
-
-        //therefore, now that we have a hold of the particular edge with the associated vertex with its
-        //associated container... we can now easily erase those edges associated with 
-        //those given vertices that are either from m_out_edges container or m_in_edges container
-        //(dependent on if associated vertex was source or target)
-        (*src_v)->m_out_edges.erase(erase_src_edg);
-      
-        (*targ_v)->m_in_edges.erase(erase_targ_edg);
-
-      }
-        
-        delete *erase_edg;
+        //every edge in the index is also in its source's outgoing list and its
+        //target's incoming list (erase_vertex keeps it that way), and both are
+        //keyed by descriptor, so each unlink is a direct keyed erase rather
+        //than a search: O(1) with the hash set, O(log d) with std::set
+        m_vertices.get(ed.first)->m_out_edges.erase(e);
+        m_vertices.get(ed.second)->m_in_edges.erase(e);
 
         //erase the edge from the set that contains all edges 
         m_edges.erase(erase_edg);
+        destroy(e);
       }
 
 	}
+
+    ///@brief Erase every edge of a range of edge_descriptor. Descriptors not
+    ///       in the graph are ignored. Returns the number of edges erased.
+    template<typename InputIterator>
+    size_t erase_edges(InputIterator first, InputIterator last) {
+      size_t erased = 0;
+      for(; first != last; ++first) {
+        size_t before = m_edges.size();
+        erase_edge(*first);
+        erased += before - m_edges.size();
+      }
+      return erased;
+    }
 	////end of @todo
 	
     void clear() {
       m_max_vd = 0;
       for(auto v : m_vertices)
-        delete v;
+        destroy(v);
       m_vertices.clear();
       for(auto e : m_edges)
-        delete e;
+        destroy(e);
       m_edges.clear();
     }
 
+    ///@brief Bytes held by the graph, by what they store. Container bytes
+    ///       are counted by the counting_arena behind the slot map, the edge
+    ///       container and the adjacency containers; the arena overhead is
+    ///       what the arena reserved beyond all of that.
+    graph_memory_usage memory_usage() const {
+      graph_memory_usage u;
+      u.vertex_index = m_vertex_arena.bytes();
+      u.edge_index = m_edge_arena.bytes();
+      u.adjacency = m_adjacency_arena.bytes();
+      u.vertex_objects = m_vertices.size() * sizeof(vertex);
+      u.edge_objects = m_edges.size() * sizeof(edge);
+      size_t used = u.vertex_bytes() + u.edge_bytes();
+      u.arena_overhead = m_arena.bytes_reserved() > used ? m_arena.bytes_reserved() - used : 0;
+      return u;
+    }
+
     // Friend declarations for input/output.
-    template<typename V, typename E>
-    friend std::istream& operator>>(std::istream&, graph<V, E>&);
-    template<typename V, typename E>
-    friend std::ostream& operator<<(std::ostream&, const graph<V, E>&);
+    template<typename V, typename E, typename A>
+    friend std::istream& operator>>(std::istream&, graph<V, E, A>&);
+    template<typename V, typename E, typename A>
+    friend std::ostream& operator<<(std::ostream&, const graph<V, E, A>&);
 
   private:
+    ///@brief Construct a node of type T in memory drawn from the arena.
+    template<typename T, typename... Args>
+    T* create(Args&&... args) {
+      void* p = m_arena.allocate(sizeof(T));
+      return new(p) T(std::forward<Args>(args)...);
+    }
+
+    ///@brief Destroy a node made by create() and hand its memory back.
+    template<typename T>
+    void destroy(T* t) {
+      t->~T();
+      m_arena.deallocate(t, sizeof(T));
+    }
+
+    Arena m_arena; //< Backs every node, declared first so it is destroyed last
+    counting_arena<Arena> m_vertex_arena;    //< Counts the slot map's bytes
+    counting_arena<Arena> m_edge_arena;      //< Counts the edge container's bytes
+    counting_arena<Arena> m_adjacency_arena; //< Counts every adjacency container's bytes
 	size_t m_max_vd; //< Maximum vertex descriptor assigned
     MyVertexContainer m_vertices; //<Contains all vertices
     MyEdgeContainer m_edges;    //<Contains all edges
@@ -280,8 +418,11 @@ class graph {
     class vertex {
         public:
           ///required constructors/destructors
-          vertex(vertex_descriptor vd, const VertexProperty& v) :
-            m_descriptor(vd), m_property(v) { }
+          vertex(vertex_descriptor vd, const VertexProperty& v,
+              counting_arena<Arena>* a) :
+            m_descriptor(vd), m_property(v),
+            m_out_edges(arena_allocator<edge*, counting_arena<Arena>>(a)),
+            m_in_edges(arena_allocator<edge*, counting_arena<Arena>>(a)) { }
 
           ///required vertex operations
 
@@ -291,7 +432,15 @@ class graph {
           adj_edge_iterator end() {return m_out_edges.end();}
           const_adj_edge_iterator cend() const {return m_out_edges.cend();}
 
+          //incoming edge iterators
+          adj_edge_iterator in_begin() {return m_in_edges.begin();}
+          const_adj_edge_iterator in_cbegin() const {return m_in_edges.cbegin();}
+          adj_edge_iterator in_end() {return m_in_edges.end();}
+          const_adj_edge_iterator in_cend() const {return m_in_edges.cend();}
+
           //accessors
+          size_t out_degree() const {return m_out_edges.size();}
+          size_t in_degree() const {return m_in_edges.size();}
           const vertex_descriptor descriptor() const {return m_descriptor;}
           VertexProperty& property() {return m_property;}
           const VertexProperty& property() const {return m_property;}
@@ -330,31 +479,9 @@ class graph {
         EdgeProperty m_property;    // Label or weight of the edge 
     };
 	
-	struct vertex_hash {
-        size_t operator()(vertex* const& v) const {
-          return h(v->descriptor());
-        }
-        std::hash<vertex_descriptor> h;
-    };
-    // Uncomment if you have boost in your machine
-   /* struct edge_hash {
-	  // You can re-write this function to create the hash-value for a pair i.e., edge descriptor
-	  // instead of using boost::hash
-      size_t operator()(edge* const& e) const {
-        return h(e->descriptor());
-	  }
-      boost::hash<edge_descriptor> h;
-    };*/
-
-    struct vertex_eq {
-      bool operator()(vertex* const& u, vertex* const& v) const {
-        return u->descriptor() == v->descriptor();
-      }
-    };
-
-    struct edge_eq {
-      bool operator()(edge* const& e, edge* const& f) const {
-        return e->descriptor() == f->descriptor();
+    struct edge_key {
+      edge_descriptor operator()(const edge* e) const {
+        return e->descriptor();
       }
     };
 	
@@ -366,28 +493,24 @@ class graph {
 };
 
 ///@brief Define io operations for the graph.
-template<typename V, typename E>
-std::istream& operator>>(std::istream& is, graph<V, E>& g) {
+template<typename V, typename E, typename A>
+std::istream& operator>>(std::istream& is, graph<V, E, A>& g) {
     size_t num_verts, num_edges;
     is >> num_verts >> num_edges;
-    g.m_vertices.reserve(num_verts);
-    g.m_vertices.reserve(num_edges);
-    for(size_t i = 0; i < num_verts; ++i) {
-      V v;
+    std::vector<V> verts(num_verts);
+    for(auto& v : verts)
       is >> v;
-      g.insert_vertex(v);
-    }
-    for(size_t i = 0; i < num_edges; ++i) {
-      typename graph<V, E>::vertex_descriptor s, t;
-      E e;
-      is >> s >> t >> e;
-      g.insert_edge(s, t, e);
-    }
+    g.m_vertices.reserve(g.m_max_vd + num_verts);
+    g.insert_vertices(verts.begin(), verts.end());
+    std::vector<typename graph<V, E, A>::edge_value> edges(num_edges);
+    for(auto& ev : edges)
+      is >> ev.first.first >> ev.first.second >> ev.second;
+    g.insert_edges(edges.begin(), edges.end());
     return is;
 }
 
-template<typename V, typename E>
-std::ostream& operator<<(std::ostream& os, const graph<V, E>& g) {
+template<typename V, typename E, typename A>
+std::ostream& operator<<(std::ostream& os, const graph<V, E, A>& g) {
     os << g.num_vertices() << " " << g.num_edges() << std::endl;
     for(auto i = g.vertices_cbegin(); i != g.vertices_cend(); ++i)
       os << (*i)->property() << std::endl;
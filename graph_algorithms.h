@@ -1,10 +1,14 @@
 #ifndef _GRAPH_ALGORITHMS_H_
 #define _GRAPH_ALGORITHMS_H_
 
-#include <stack> 
-#include <queue>
-#include <unordered_set>
-//#include <boost/functional/hash.hpp> // Uncomment this if you have boost installed
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "graph_csr.h"
+#include "graph_heap.h"
 
 
 // This is an example list of the basic algorithms we will work with in class.
@@ -15,65 +19,115 @@
 //
 //  - ParentMap: associative container between vertex_descriptors and parent
 //               vertex_descriptors. This is a representation of the free
-//               trees/forests created by these search methods.
+//               trees/forests created by these search methods. A
+//               std::vector<vertex_descriptor> can be used as a dense map;
+//               it is sized by descriptor and -1 marks roots and gaps.
 //
 //  - DistanceMap: associative container between vertex_descriptors and
 //                 EdgeProperties. This represents the summation of the path
-//                 weights to the vertex itself.
+//                 weights to the vertex itself. As with ParentMap, a
+//                 std::vector<EdgeProperty> works as a dense map.
 //
 // Assume EdgeProperties can be added and compared with less than/less than or
 // equal.
 //
 
 
+///@brief Reset a ParentMap before a search over a graph whose descriptors are
+///       below slots. An associative map is emptied, and the search then adds
+///       an entry per vertex. A std::vector is resized to slots and filled
+///       with -1, so the search writes by index and never hashes.
+template<typename ParentMap>
+void reset_parent_map(ParentMap& p, size_t) {
+  p.clear();
+}
+
+template<typename T, typename A>
+void reset_parent_map(std::vector<T, A>& p, size_t slots) {
+  p.assign(slots, T(-1));
+}
+
+
+///@brief Reset a DistanceMap before a search over a graph whose descriptors
+///       are below slots. A std::vector is filled with inf.
+template<typename DistanceMap, typename W>
+void reset_distance_map(DistanceMap& d, size_t, const W&) {
+  d.clear();
+}
+
+template<typename T, typename A, typename W>
+void reset_distance_map(std::vector<T, A>& d, size_t slots, const W& inf) {
+  d.assign(slots, inf);
+}
+
+
+///@brief The EdgeProperty of Graph, used as the edge weight by the shortest
+///       path algorithms.
+template<typename Graph>
+struct edge_weight {
+  typedef typename std::decay<decltype((*std::declval<
+      typename Graph::const_adj_edge_iterator>())->property())>::type type;
+};
+
+
+///@brief Index the vertices of g by descriptor. index[vd] is the vertex with
+///       descriptor vd, or nullptr if there is none. Lets the searches below
+///       follow an edge to its target without calling find_vertex.
+template<typename Graph, typename VertexPtr>
+void index_vertices(const Graph& g, std::vector<VertexPtr>& index) {
+  size_t slots = 0;
+  for(auto vi = g.vertices_cbegin(); vi != g.vertices_cend(); ++vi)
+    slots = std::max(slots, (*vi)->descriptor() + 1);
+  index.assign(slots, nullptr);
+  for(auto vi = g.vertices_cbegin(); vi != g.vertices_cend(); ++vi)
+    index[(*vi)->descriptor()] = *vi;
+}
+
+
 ///@brief Implement breadth-first search.
+///
+/// Vertices are tracked in a bitmap indexed by descriptor, so the search
+/// costs O(V+E) and allocates nothing per edge. Edges to vertices that are
+/// no longer in the graph are ignored.
 template<typename Graph, typename ParentMap>
   void breadth_first_search(const Graph& g, ParentMap& p) {
     typedef typename Graph::vertex_descriptor vertex_descriptor;
-    typedef typename Graph::edge_descriptor edge_descriptor;
     typedef typename Graph::const_vertex_iterator vertex_iterator;
-    typedef typename Graph::const_edge_iterator edge_iterator;
     typedef typename Graph::const_adj_edge_iterator adj_edge_iterator;
+    typedef typename std::decay<decltype(*g.vertices_cbegin())>::type vertex_ptr;
 
-    //setup
-    std::queue<vertex_descriptor> q;
-    //std::unordered_set<edge_descriptor, boost::hash<edge_descriptor>> edges_unexplored;
-	std::set<edge_descriptor> edges_unexplored;
-    std::unordered_set<vertex_descriptor> vertices_unexplored;
+    //setup, every vertex is enqueued exactly once so a flat array is the queue
+    std::vector<vertex_ptr> vertices;
+    index_vertices(g, vertices);
+    std::vector<bool> explored(vertices.size(), true);
+    std::vector<vertex_ptr> q(g.num_vertices());
+    size_t head = 0, tail = 0;
 
     //initialize
-    p.clear();
+    reset_parent_map(p, vertices.size());
     for(vertex_iterator vi = g.vertices_cbegin(); vi != g.vertices_cend(); ++vi) {
       vertex_descriptor vd = (*vi)->descriptor();
-      vertices_unexplored.emplace(vd);
+      explored[vd] = false;
       p[vd] = -1;
     }
-    for(edge_iterator ei = g.edges_cbegin(); ei != g.edges_cend(); ++ei)
-      edges_unexplored.emplace((*ei)->descriptor());
 
     //for each CC
     for(vertex_iterator vi = g.vertices_cbegin(); vi != g.vertices_cend(); ++vi) {
       vertex_descriptor vd = (*vi)->descriptor();
-      if(vertices_unexplored.count(vd)) {
-        q.push(vd);
-        vertices_unexplored.erase(vd);
-        while(!q.empty()) {
-          vertex_descriptor vd = q.front();
-          q.pop();
-          auto& v = *g.find_vertex(vd);
+      if(!explored[vd]) {
+        q[tail++] = *vi;
+        explored[vd] = true;
+        while(head != tail) {
+          vertex_ptr v = q[head++];
           for(adj_edge_iterator aei = v->begin(); aei != v->end(); ++aei) {
-            auto el = edges_unexplored.find((*aei)->descriptor());
-            if(el != edges_unexplored.end()) {
-              vertex_descriptor t = (*aei)->target();
-              if(vertices_unexplored.count(t)) {
-                //discovery edge
-                edges_unexplored.erase(el);
-                p[t] = v->descriptor();
-                q.push(t);
-                vertices_unexplored.erase(t);
-              }
-              //else cross edge
+            vertex_descriptor t = (*aei)->target();
+            if(t < explored.size() && !explored[t]) {
+              //discovery edge
+              p[t] = v->descriptor();
+              q[tail++] = vertices[t];
+              explored[t] = true;
             }
+            //else cross edge
           }
         }
       }
@@ -81,55 +135,49 @@ template<typename Graph, typename ParentMap>
   }
 
 
-///@todo Implement depth-first search.
+///@brief Depth-first search. Uses the same descriptor-indexed bookkeeping as
+///       breadth_first_search.
 template<typename Graph, typename ParentMap>
 void depth_first_search(const Graph& g, ParentMap& p){
 
   typedef typename Graph::vertex_descriptor vertex_descriptor;
-    typedef typename Graph::edge_descriptor edge_descriptor;
     typedef typename Graph::const_vertex_iterator vertex_iterator;
-    typedef typename Graph::const_edge_iterator edge_iterator;
     typedef typename Graph::const_adj_edge_iterator adj_edge_iterator;
+    typedef typename std::decay<decltype(*g.vertices_cbegin())>::type vertex_ptr;
 
     //setup
-    std::stack<vertex_descriptor> stk;
-    //std::unordered_set<edge_descriptor, boost::hash<edge_descriptor>> edges_unexplored;
-	std::set<edge_descriptor> edges_unexplored;
-    std::unordered_set<vertex_descriptor> vertices_unexplored;
+    std::vector<vertex_ptr> vertices;
+    index_vertices(g, vertices);
+    std::vector<bool> explored(vertices.size(), true);
+    std::vector<vertex_ptr> stk;
+    stk.reserve(g.num_vertices());
 
     //initialize
-    p.clear();
+    reset_parent_map(p, vertices.size());
     for(vertex_iterator vi = g.vertices_cbegin(); vi != g.vertices_cend(); ++vi) {
       vertex_descriptor vd = (*vi)->descriptor();
-      vertices_unexplored.emplace(vd);
+      explored[vd] = false;
       p[vd] = -1;
     }
-    for(edge_iterator ei = g.edges_cbegin(); ei != g.edges_cend(); ++ei)
-      edges_unexplored.emplace((*ei)->descriptor());
 
     //for each CC
     for(vertex_iterator vi = g.vertices_cbegin(); vi != g.vertices_cend(); ++vi) {
       vertex_descriptor vd = (*vi)->descriptor();
-      if(vertices_unexplored.count(vd)) {
-        stk.push(vd);
-        vertices_unexplored.erase(vd);
+      if(!explored[vd]) {
+        stk.push_back(*vi);
+        explored[vd] = true;
         while(!stk.empty()) {
-          vertex_descriptor vd = stk.top();
-          stk.pop();
-          auto& v = *g.find_vertex(vd);
+          vertex_ptr v = stk.back();
+          stk.pop_back();
           for(adj_edge_iterator aei = v->begin(); aei != v->end(); ++aei) {
-            auto el = edges_unexplored.find((*aei)->descriptor());
-            if(el != edges_unexplored.end()) {
-              vertex_descriptor t = (*aei)->target();
-              if(vertices_unexplored.count(t)) {
-                //discovery edge
-                edges_unexplored.erase(el);
-                p[t] = v->descriptor();
-                stk.push(t);
-                vertices_unexplored.erase(t);
-              }
-              //else cross edge
+            vertex_descriptor t = (*aei)->target();
+            if(t < explored.size() && !explored[t]) {
+              //discovery edge
+              p[t] = v->descriptor();
+              stk.push_back(vertices[t]);
+              explored[t] = true;
             }
+            //else cross edge
           }
         }
       }
@@ -137,4 +185,403 @@ void depth_first_search(const Graph& g, ParentMap& p){
 	
 }
 
+
+///@brief Direction chosen for one level of direction_optimizing_bfs.
+enum class bfs_direction {top_down, bottom_up};
+
+///@brief Switching thresholds for direction_optimizing_bfs.
+///
+/// A top-down level switches to bottom-up once the edges leaving the frontier
+/// exceed 1/alpha of the edges leaving unexplored vertices. A bottom-up level
+/// switches back to top-down once the frontier holds fewer than 1/beta of the
+/// vertices.
+struct bfs_direction_params {
+  double alpha = 14;
+  double beta = 24;
+};
+
+///@brief Record of one level of direction_optimizing_bfs.
+struct bfs_level_trace {
+  size_t root;            // Descriptor the search of this component started at
+  size_t level;           // Distance of the frontier from root
+  bfs_direction direction;
+  size_t frontier_size;   // Vertices expanded on this level
+  size_t edges_examined;  // Out-edges (top-down) or in-edges (bottom-up) looked at
+};
+
+
+///@brief Direction-optimizing breadth-first search.
+///
+/// Levels are expanded either top-down, following out-edges of the frontier,
+/// or bottom-up, where every unexplored vertex scans its in-edges for a parent
+/// on the frontier and stops at the first one found. Bottom-up pays off once
+/// the frontier covers a large part of the graph. The resulting ParentMap is a
+/// breadth-first forest with the same depths as breadth_first_search, though
+/// a vertex may get a different parent at the same depth. If trace is given,
+/// one entry is appended per level.
+template<typename Graph, typename ParentMap>
+void direction_optimizing_bfs(const Graph& g, ParentMap& p,
+    const bfs_direction_params& params = bfs_direction_params(),
+    std::vector<bfs_level_trace>* trace = nullptr) {
+  typedef typename Graph::vertex_descriptor vertex_descriptor;
+  typedef typename Graph::const_vertex_iterator vertex_iterator;
+  typedef typename Graph::const_adj_edge_iterator adj_edge_iterator;
+  typedef typename std::decay<decltype(*g.vertices_cbegin())>::type vertex_ptr;
+
+  //setup
+  std::vector<vertex_ptr> vertices;
+  index_vertices(g, vertices);
+  std::vector<bool> explored(vertices.size(), true);
+  std::vector<bool> in_frontier(vertices.size(), false);
+  std::vector<vertex_ptr> frontier, next;
+  frontier.reserve(g.num_vertices());
+  next.reserve(g.num_vertices());
+
+  //initialize, unexplored_edges counts the out-edges of unexplored vertices
+  size_t unexplored_edges = 0;
+  reset_parent_map(p, vertices.size());
+  for(vertex_iterator vi = g.vertices_cbegin(); vi != g.vertices_cend(); ++vi) {
+    vertex_descriptor vd = (*vi)->descriptor();
+    explored[vd] = false;
+    p[vd] = -1;
+    unexplored_edges += (*vi)->out_degree();
+  }
+
+  //for each CC
+  for(vertex_iterator vi = g.vertices_cbegin(); vi != g.vertices_cend(); ++vi) {
+    vertex_descriptor root = (*vi)->descriptor();
+    if(explored[root])
+      continue;
+    explored[root] = true;
+    unexplored_edges -= (*vi)->out_degree();
+    frontier.assign(1, *vi);
+    bfs_direction dir = bfs_direction::top_down;
+
+    for(size_t level = 0; !frontier.empty(); ++level) {
+      size_t frontier_edges = 0;
+      for(auto v : frontier)
+        frontier_edges += v->out_degree();
+      if(dir == bfs_direction::top_down &&
+          frontier_edges > unexplored_edges / params.alpha)
+        dir = bfs_direction::bottom_up;
+      else if(dir == bfs_direction::bottom_up &&
+          frontier.size() < g.num_vertices() / params.beta)
+        dir = bfs_direction::top_down;
+
+      size_t examined = 0;
+      next.clear();
+      if(dir == bfs_direction::top_down) {
+        for(auto v : frontier) {
+          for(adj_edge_iterator aei = v->begin(); aei != v->end(); ++aei) {
+            ++examined;
+            vertex_descriptor t = (*aei)->target();
+            if(t < explored.size() && !explored[t]) {
+              //discovery edge
+              explored[t] = true;
+              p[t] = v->descriptor();
+              next.push_back(vertices[t]);
+              unexplored_edges -= vertices[t]->out_degree();
+            }
+          }
+        }
+      }
+      else {
+        for(auto v : frontier)
+          in_frontier[v->descriptor()] = true;
+        for(size_t u = 0; u < vertices.size(); ++u) {
+          if(explored[u])
+            continue;
+          vertex_ptr w = vertices[u];
+          for(adj_edge_iterator aei = w->in_begin(); aei != w->in_end(); ++aei) {
+            ++examined;
+            vertex_descriptor s = (*aei)->source();
+            if(s < in_frontier.size() && in_frontier[s]) {
+              //discovery edge, the first parent found is enough
+              explored[u] = true;
+              p[u] = s;
+              next.push_back(w);
+              unexplored_edges -= w->out_degree();
+              break;
+            }
+          }
+        }
+        for(auto v : frontier)
+          in_frontier[v->descriptor()] = false;
+      }
+
+      if(trace)
+        trace->push_back({root, level, dir, frontier.size(), examined});
+      frontier.swap(next);
+    }
+  }
+}
+
+
+///@brief Bit-parallel multi-source breadth-first search (MS-BFS).
+///
+/// Runs one breadth-first search per vertex in sources, sharing the adjacency
+/// scans between them. Sources are processed in batches of 64; within a batch
+/// each vertex keeps a 64-bit word of the searches that have seen it and of
+/// those whose frontier it is on, so one pass over an out-edge advances every
+/// search in the batch at once.
+///
+/// On return dist[i][vd] is the number of edges on a shortest path from
+/// sources[i] to vd and parent[i][vd] the previous vertex on it. Both are -1
+/// for unreachable vertices and descriptors without a vertex, and parent is
+/// -1 for the source itself. Every source must be a vertex of g.
+template<typename Graph>
+void multi_source_bfs(const Graph& g,
+    const std::vector<typename Graph::vertex_descriptor>& sources,
+    std::vector<std::vector<size_t>>& dist,
+    std::vector<std::vector<typename Graph::vertex_descriptor>>& parent) {
+  typedef typename Graph::vertex_descriptor vertex_descriptor;
+  typedef typename Graph::const_adj_edge_iterator adj_edge_iterator;
+  typedef typename std::decay<decltype(*g.vertices_cbegin())>::type vertex_ptr;
+  typedef unsigned long long word;
+  const size_t width = 64;
+
+  //setup
+  std::vector<vertex_ptr> vertices;
+  index_vertices(g, vertices);
+  size_t slots = vertices.size();
+  std::vector<word> seen(slots), visit(slots), visit_next(slots);
+  dist.assign(sources.size(), std::vector<size_t>(slots, size_t(-1)));
+  parent.assign(sources.size(),
+      std::vector<vertex_descriptor>(slots, vertex_descriptor(-1)));
+
+  for(size_t batch = 0; batch < sources.size(); batch += width) {
+    size_t count = std::min(width, sources.size() - batch);
+    std::fill(seen.begin(), seen.end(), 0);
+    std::fill(visit.begin(), visit.end(), 0);
+    std::fill(visit_next.begin(), visit_next.end(), 0);
+
+    //initialize
+    for(size_t i = 0; i < count; ++i) {
+      vertex_descriptor s = sources[batch + i];
+      seen[s] |= word(1) << i;
+      visit[s] |= word(1) << i;
+      dist[batch + i][s] = 0;
+    }
+
+    for(size_t level = 1; ; ++level) {
+      bool active = false;
+      for(size_t v = 0; v < slots; ++v) {
+        word frontier = visit[v];
+        if(!frontier)
+          continue;
+        for(adj_edge_iterator aei = vertices[v]->begin();
+            aei != vertices[v]->end(); ++aei) {
+          vertex_descriptor t = (*aei)->target();
+          if(t >= slots || !vertices[t])
+            continue;
+          word discovered = frontier & ~seen[t];
+          if(!discovered)
+            continue;
+          //discovery edge for every search in discovered
+          active = true;
+          seen[t] |= discovered;
+          visit_next[t] |= discovered;
+          for(; discovered; discovered &= discovered - 1) {
+            size_t i = batch + __builtin_ctzll(discovered);
+            dist[i][t] = level;
+            parent[i][t] = v;
+          }
+        }
+      }
+      if(!active)
+        break;
+      visit.swap(visit_next);
+      std::fill(visit_next.begin(), visit_next.end(), 0);
+    }
+  }
+}
+
+
+///@brief Dijkstra's shortest paths from the vertices in [first, last), taken
+///       in order. Each one that is still unreached when its turn comes
+///       becomes the root of a new shortest path tree with distance
+///       EdgeProperty(). Weights must be non-negative. Vertices that are not
+///       reached get parent -1 and distance numeric_limits<EdgeProperty>::max().
+///
+/// The queue is a 4-ary indexed heap keyed by descriptor, so every vertex is
+/// queued at most once and improvements are decrease-key operations.
+template<typename Graph, typename RootIterator, typename ParentMap,
+         typename DistanceMap>
+void dijkstra_shortest_paths(const Graph& g, RootIterator first,
+    RootIterator last, ParentMap& p, DistanceMap& d) {
+  typedef typename Graph::vertex_descriptor vertex_descriptor;
+  typedef typename Graph::const_vertex_iterator vertex_iterator;
+  typedef typename Graph::const_adj_edge_iterator adj_edge_iterator;
+  typedef typename edge_weight<Graph>::type weight;
+  typedef typename std::decay<decltype(*g.vertices_cbegin())>::type vertex_ptr;
+  const weight inf = std::numeric_limits<weight>::max();
+
+  //setup
+  std::vector<vertex_ptr> vertices;
+  index_vertices(g, vertices);
+  size_t slots = vertices.size();
+  std::vector<weight> dist(slots, inf);
+  std::vector<vertex_descriptor> parent(slots, vertex_descriptor(-1));
+  d_ary_heap<weight> q(slots);
+
+  for(; first != last; ++first) {
+    vertex_descriptor root = *first;
+    if(root >= slots || !vertices[root] || dist[root] != inf)
+      continue;
+    dist[root] = weight();
+    q.push(root, dist[root]);
+    while(!q.empty()) {
+      vertex_descriptor u = q.pop();
+      vertex_ptr v = vertices[u];
+      for(adj_edge_iterator aei = v->begin(); aei != v->end(); ++aei) {
+        vertex_descriptor t = (*aei)->target();
+        if(t >= slots || !vertices[t])
+          continue;
+        weight nd = dist[u] + (*aei)->property();
+        if(nd < dist[t]) {
+          //tree edge, for now
+          dist[t] = nd;
+          parent[t] = u;
+          q.push(t, nd);
+        }
+      }
+    }
+  }
+
+  //publish
+  reset_parent_map(p, slots);
+  reset_distance_map(d, slots, inf);
+  for(vertex_iterator vi = g.vertices_cbegin(); vi != g.vertices_cend(); ++vi) {
+    vertex_descriptor vd = (*vi)->descriptor();
+    p[vd] = parent[vd];
+    d[vd] = dist[vd];
+  }
+}
+
+///@brief Dijkstra's shortest paths from a single source.
+template<typename Graph, typename ParentMap, typename DistanceMap>
+void dijkstra_shortest_paths(const Graph& g,
+    typename Graph::vertex_descriptor source, ParentMap& p, DistanceMap& d) {
+  dijkstra_shortest_paths(g, &source, &source + 1, p, d);
+}
+
+///@brief Dijkstra's shortest paths forest. Roots are taken in vertex order,
+///       like the components of breadth_first_search.
+template<typename Graph, typename ParentMap, typename DistanceMap>
+void dijkstra_shortest_paths(const Graph& g, ParentMap& p, DistanceMap& d) {
+  std::vector<typename Graph::vertex_descriptor> roots;
+  roots.reserve(g.num_vertices());
+  for(auto vi = g.vertices_cbegin(); vi != g.vertices_cend(); ++vi)
+    roots.push_back((*vi)->descriptor());
+  dijkstra_shortest_paths(g, roots.begin(), roots.end(), p, d);
+}
+
+
+///@brief Call f(t) for every target t of vertex vd of a graph with the
+///       graph_csr interface, through its adjacency iterator. Snapshots that
+///       can enumerate a whole list faster than one target per increment
+///       (graph_compressed) overload it; the traversals below call it
+///       unqualified so the overload is found by argument-dependent lookup.
+template<typename CSRGraph, typename F>
+void csr_for_each_target(const CSRGraph& g, size_t vd, F f) {
+  for(auto ai = g.out_begin(vd); ai != g.out_end(vd); ++ai)
+    f(*ai);
+}
+
+
+///@brief Breadth-first search over any graph with the graph_csr interface
+///       (graph_csr, graph_mapped). Produces the same parent map as the
+///       adjacency-list version, with components started in ascending
+///       descriptor order.
+template<typename CSRGraph, typename ParentMap>
+void csr_breadth_first_search(const CSRGraph& g, ParentMap& p) {
+  typedef typename CSRGraph::vertex_descriptor vertex_descriptor;
+  typedef typename CSRGraph::const_vertex_iterator vertex_iterator;
+
+  //setup, every vertex is enqueued exactly once so a flat array is the queue
+  std::vector<bool> explored(g.num_slots(), false);
+  std::vector<vertex_descriptor> q(g.num_vertices());
+  size_t head = 0, tail = 0;
+
+  //initialize
+  reset_parent_map(p, g.num_slots());
+  for(vertex_iterator vi = g.vertices_cbegin(); vi != g.vertices_cend(); ++vi)
+    p[*vi] = -1;
+
+  //for each CC
+  for(vertex_iterator vi = g.vertices_cbegin(); vi != g.vertices_cend(); ++vi) {
+    if(explored[*vi])
+      continue;
+    explored[*vi] = true;
+    q[tail++] = *vi;
+    while(head != tail) {
+      vertex_descriptor vd = q[head++];
+      csr_for_each_target(g, vd, [&](vertex_descriptor t) {
+        if(!explored[t]) {
+          //discovery edge
+          explored[t] = true;
+          p[t] = vd;
+          q[tail++] = t;
+        }
+        //else cross edge
+      });
+    }
+  }
+}
+
+
+///@brief Depth-first search over any graph with the graph_csr interface
+///       (graph_csr, graph_mapped). Produces the same parent map as the
+///       adjacency-list version, with components started in ascending
+///       descriptor order.
+template<typename CSRGraph, typename ParentMap>
+void csr_depth_first_search(const CSRGraph& g, ParentMap& p) {
+  typedef typename CSRGraph::vertex_descriptor vertex_descriptor;
+  typedef typename CSRGraph::const_vertex_iterator vertex_iterator;
+
+  //setup
+  std::vector<bool> explored(g.num_slots(), false);
+  std::vector<vertex_descriptor> stk;
+  stk.reserve(g.num_vertices());
+
+  //initialize
+  reset_parent_map(p, g.num_slots());
+  for(vertex_iterator vi = g.vertices_cbegin(); vi != g.vertices_cend(); ++vi)
+    p[*vi] = -1;
+
+  //for each CC
+  for(vertex_iterator vi = g.vertices_cbegin(); vi != g.vertices_cend(); ++vi) {
+    if(explored[*vi])
+      continue;
+    explored[*vi] = true;
+    stk.push_back(*vi);
+    while(!stk.empty()) {
+      vertex_descriptor vd = stk.back();
+      stk.pop_back();
+      csr_for_each_target(g, vd, [&](vertex_descriptor t) {
+        if(!explored[t]) {
+          //discovery edge
+          explored[t] = true;
+          p[t] = vd;
+          stk.push_back(t);
+        }
+        //else cross edge
+      });
+    }
+  }
+}
+
+
+///@brief Breadth-first search over a CSR snapshot.
+template<typename V, typename E, typename ParentMap>
+void breadth_first_search(const graph_csr<V, E>& g, ParentMap& p) {
+  csr_breadth_first_search(g, p);
+}
+
+///@brief Depth-first search over a CSR snapshot.
+template<typename V, typename E, typename ParentMap>
+void depth_first_search(const graph_csr<V, E>& g, ParentMap& p) {
+  csr_depth_first_search(g, p);
+}
+
 #endif
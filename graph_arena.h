@@ -0,0 +1,262 @@
+#ifndef _GRAPH_ARENA_H_
+#define _GRAPH_ARENA_H_
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// A slab arena for the small, fixed-size nodes a graph allocates: vertex and
+/// edge objects and the nodes of the containers that hold them. Memory is
+/// carved sequentially out of large slabs, so nodes created together end up
+/// adjacent, and freed blocks go on a per-size free list to be reused by the
+/// next allocation of the same size class. Requests larger than max_block
+/// (e.g., hash bucket arrays) go straight to operator new. All slabs are
+/// returned to the system when the arena is destroyed.
+////////////////////////////////////////////////////////////////////////////////
+class slab_arena {
+
+  public:
+
+    enum : size_t {
+      granularity = 16,          ///< Size classes are multiples of this
+      max_block = 256,           ///< Largest block served from a slab
+      slab_bytes = 64 * 1024,    ///< Size of each slab
+      num_classes = max_block / granularity
+    };
+
+    slab_arena() : m_cur(nullptr), m_end(nullptr), m_free(), m_reserved(0) { }
+
+    ~slab_arena() {
+      release();
+    }
+
+    slab_arena(const slab_arena&) = delete;             ///< Copy is disabled.
+    slab_arena& operator=(const slab_arena&) = delete;  ///< Copy is disabled.
+
+    ///@brief Allocate a block of at least bytes bytes.
+    void* allocate(size_t bytes) {
+      if(bytes > max_block) {
+        m_reserved += bytes;
+        return ::operator new(bytes);
+      }
+      size_t c = size_class(bytes);
+      if(free_block* b = m_free[c]) {
+        m_free[c] = b->next;
+        return b;
+      }
+      size_t sz = (c + 1) * granularity;
+      if(size_t(m_end - m_cur) < sz)
+        grow();
+      void* p = m_cur;
+      m_cur += sz;
+      return p;
+    }
+
+    ///@brief Return a block obtained from allocate(bytes) to its free list.
+    void deallocate(void* p, size_t bytes) {
+      if(!p)
+        return;
+      if(bytes > max_block) {
+        m_reserved -= bytes;
+        ::operator delete(p);
+        return;
+      }
+      size_t c = size_class(bytes);
+      free_block* b = static_cast<free_block*>(p);
+      b->next = m_free[c];
+      m_free[c] = b;
+    }
+
+    ///@brief Give every slab back to the system. Any block still handed out
+    ///       becomes invalid, so only call this once all users are gone.
+    void release() {
+      for(auto s : m_slabs)
+        ::operator delete(s);
+      m_slabs.clear();
+      m_cur = m_end = nullptr;
+      for(auto& f : m_free)
+        f = nullptr;
+      m_reserved = 0;
+    }
+
+    ///@brief Bytes obtained from the system: every slab, plus the blocks
+    ///       larger than max_block still handed out.
+    size_t bytes_reserved() const {return m_reserved;}
+
+  private:
+
+    struct free_block {
+      free_block* next;
+    };
+
+    static size_t size_class(size_t bytes) {
+      return bytes == 0 ? 0 : (bytes - 1) / granularity;
+    }
+
+    void grow() {
+      char* s = static_cast<char*>(::operator new(slab_bytes));
+      m_slabs.push_back(s);
+      m_reserved += slab_bytes;
+      m_cur = s;
+      m_end = s + slab_bytes;
+    }
+
+    char* m_cur;                       // Next free byte in the current slab
+    char* m_end;                       // End of the current slab
+    free_block* m_free[num_classes];   // Free list heads, one per size class
+    std::vector<char*> m_slabs;        // Every slab obtained so far
+    size_t m_reserved;                 // Slab bytes plus outstanding large blocks
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// An arena that forwards to the global operator new/delete. Plug it into a
+/// graph to get one heap call per node, e.g. to compare against slab_arena.
+////////////////////////////////////////////////////////////////////////////////
+class heap_arena {
+
+  public:
+
+    heap_arena() : m_reserved(0) { }
+
+    heap_arena(const heap_arena&) = delete;             ///< Copy is disabled.
+    heap_arena& operator=(const heap_arena&) = delete;  ///< Copy is disabled.
+
+    void* allocate(size_t bytes) {
+      m_reserved += bytes;
+      return ::operator new(bytes);
+    }
+    void deallocate(void* p, size_t bytes) {
+      if(!p)
+        return;
+      m_reserved -= bytes;
+      ::operator delete(p);
+    }
+    void release() { }
+
+    ///@brief Bytes requested and not yet given back. The heap's own
+    ///       bookkeeping is not included.
+    size_t bytes_reserved() const {return m_reserved;}
+
+  private:
+    size_t m_reserved; // Outstanding requested bytes
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Standard allocator adaptor so that standard containers draw their nodes
+/// from an arena. Copies (and rebound copies) share the same arena.
+////////////////////////////////////////////////////////////////////////////////
+template<typename T, typename Arena>
+class arena_allocator {
+
+  public:
+
+    typedef T value_type;
+
+    template<typename U>
+    struct rebind {
+      typedef arena_allocator<U, Arena> other;
+    };
+
+    explicit arena_allocator(Arena* a) : m_arena(a) { }
+
+    template<typename U>
+    arena_allocator(const arena_allocator<U, Arena>& other) :
+      m_arena(other.arena()) { }
+
+    T* allocate(size_t n) {
+      return static_cast<T*>(m_arena->allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n) {
+      m_arena->deallocate(p, n * sizeof(T));
+    }
+
+    Arena* arena() const {return m_arena;}
+
+    template<typename U>
+    bool operator==(const arena_allocator<U, Arena>& other) const {
+      return m_arena == other.arena();
+    }
+
+    template<typename U>
+    bool operator!=(const arena_allocator<U, Arena>& other) const {
+      return m_arena != other.arena();
+    }
+
+  private:
+    Arena* m_arena; // Arena shared by every copy of this allocator
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Forwards to another arena and counts the bytes currently allocated through
+/// it. A graph keeps one per kind of container (vertex index, edge index,
+/// adjacency) so memory_usage() can break its memory down, while the
+/// allocators of the containers still carry a single pointer.
+////////////////////////////////////////////////////////////////////////////////
+template<typename Arena>
+class counting_arena {
+
+  public:
+
+    explicit counting_arena(Arena* a) : m_arena(a), m_bytes(0) { }
+
+    counting_arena(const counting_arena&) = delete;             ///< Copy is disabled.
+    counting_arena& operator=(const counting_arena&) = delete;  ///< Copy is disabled.
+
+    void* allocate(size_t bytes) {
+      m_bytes += bytes;
+      return m_arena->allocate(bytes);
+    }
+
+    void deallocate(void* p, size_t bytes) {
+      if(p)
+        m_bytes -= bytes;
+      m_arena->deallocate(p, bytes);
+    }
+
+    ///@brief Bytes allocated and not yet given back.
+    size_t bytes() const {return m_bytes;}
+
+  private:
+    Arena* m_arena;  // Arena that does the allocation
+    size_t m_bytes;  // Outstanding bytes
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Bytes held by a graph or graph_vector, by what they store, as returned by
+/// their memory_usage(). Container figures come from counting_arena and so
+/// include unused capacity (empty hash slots, vector growth); object
+/// figures are the live objects times their size.
+////////////////////////////////////////////////////////////////////////////////
+struct graph_memory_usage {
+  size_t vertex_objects;  // Vertex objects (descriptor, property, list headers)
+  size_t edge_objects;    // Edge objects
+  size_t vertex_index;    // Vertex container and per-vertex lookup arrays
+  size_t edge_index;      // Edge container: hash slots, tree nodes or arrays
+  size_t adjacency;       // Out- and in-edge containers of every vertex
+  size_t arena_overhead;  // Held by the arena but not handed out: unused slab
+                          // space, free lists and size-class rounding
+
+  graph_memory_usage() : vertex_objects(0), edge_objects(0), vertex_index(0),
+    edge_index(0), adjacency(0), arena_overhead(0) { }
+
+  ///@brief Bytes attributable to vertices and to edges, and everything.
+  size_t vertex_bytes() const {return vertex_objects + vertex_index;}
+  size_t edge_bytes() const {return edge_objects + edge_index + adjacency;}
+  size_t total() const {return vertex_bytes() + edge_bytes() + arena_overhead;}
+
+  double bytes_per_vertex(size_t num_vertices) const {
+    return num_vertices ? double(vertex_bytes()) / num_vertices : 0;
+  }
+  double bytes_per_edge(size_t num_edges) const {
+    return num_edges ? double(edge_bytes()) / num_edges : 0;
+  }
+};
+
+#endif
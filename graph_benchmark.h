@@ -0,0 +1,365 @@
+#ifndef _GRAPH_BENCHMARK_H_
+#define _GRAPH_BENCHMARK_H_
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <istream>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include "graph_algorithms.h"
+#include "graph_perf_counters.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Building blocks of the benchmark program (benchmark.cpp) and of the
+/// per-size loop of timing.cpp: the timed phases of one graph, summary
+/// statistics over repetitions, peak resident set size, CSV/JSON output, and
+/// comparison against a baseline saved as CSV.
+////////////////////////////////////////////////////////////////////////////////
+
+///@brief Phases timed by time_phases(), in the order they run.
+enum class benchmark_phase {
+  create,  // Generate the graph with the bulk inserts
+  bfs,     // breadth_first_search
+  dfs,     // depth_first_search
+  erase    // Erase a quarter of the edges as a batch, then a quarter of the vertices
+};
+
+enum {num_benchmark_phases = 4};
+
+inline const char* phase_name(benchmark_phase p) {
+  static const char* names[] = {"create", "bfs", "dfs", "erase"};
+  return names[int(p)];
+}
+
+///@brief Phase called name. Returns false if there is none.
+inline bool parse_phase(const std::string& name, benchmark_phase& p) {
+  for(int i = 0; i < num_benchmark_phases; ++i)
+    if(name == phase_name(benchmark_phase(i))) {
+      p = benchmark_phase(i);
+      return true;
+    }
+  return false;
+}
+
+///@brief Bit of phase p in the phase masks of time_phases().
+inline unsigned phase_bit(benchmark_phase p) {return 1u << int(p);}
+const unsigned all_benchmark_phases = (1u << num_benchmark_phases) - 1;
+
+
+///@brief Memory held by the graph built by time_phases(), right after create.
+struct graph_footprint {
+  graph_memory_usage usage;
+  size_t num_vertices;
+  size_t num_edges;
+
+  graph_footprint() : num_vertices(0), num_edges(0) { }
+
+  double bytes_per_vertex() const {return usage.bytes_per_vertex(num_vertices);}
+  double bytes_per_edge() const {return usage.bytes_per_edge(num_edges);}
+};
+
+
+///@brief Build a graph of size n with init and run the phases selected in
+///       mask on it, in order. seconds must have num_benchmark_phases
+///       entries; seconds[p] is set for every selected phase p. If counters
+///       is given, the events counted during each selected phase are
+///       written to readings, which also has num_benchmark_phases entries.
+///       If footprint is given, the memory usage of the new graph is
+///       written to it after the create phase. The graph is always
+///       created, whether or not create is selected, and the erase phase
+///       draws from rand().
+template<typename graph_id, typename Initializer>
+void time_phases(Initializer init, size_t n, unsigned mask, double* seconds,
+    perf_counters* counters = nullptr, perf_reading* readings = nullptr,
+    graph_footprint* footprint = nullptr) {
+  using namespace std::chrono;
+  high_resolution_clock::time_point start;
+  //counters run outside the timed interval, so their system calls are not timed
+  auto begin = [&]() {
+    if(counters)
+      counters->start();
+    start = high_resolution_clock::now();
+  };
+  auto end = [&](benchmark_phase p) {
+    seconds[int(p)] = duration_cast<duration<double>>(high_resolution_clock::now() - start).count();
+    if(counters)
+      readings[int(p)] = counters->stop();
+  };
+
+  begin();
+  //create graph, testing insertion
+  graph_id g;
+  init(g, n);
+  end(benchmark_phase::create);
+  if(footprint) {
+    footprint->usage = g.memory_usage();
+    footprint->num_vertices = g.num_vertices();
+    footprint->num_edges = g.num_edges();
+  }
+
+  typedef typename graph_id::vertex_descriptor vertex_descriptor;
+  std::unordered_map<vertex_descriptor, vertex_descriptor> parent_map;
+  if(mask & phase_bit(benchmark_phase::bfs)) {
+    begin();
+    breadth_first_search(g, parent_map);
+    end(benchmark_phase::bfs);
+  }
+
+  if(mask & phase_bit(benchmark_phase::dfs)) {
+    parent_map.clear();
+    begin();
+    depth_first_search(g, parent_map);
+    end(benchmark_phase::dfs);
+  }
+
+  if(mask & phase_bit(benchmark_phase::erase)) {
+    begin();
+    //a uniform sample of a quarter of the edges, erased as one batch
+    size_t quarter_edge = g.num_edges() / 4;
+    std::vector<typename graph_id::edge_descriptor> erase_batch;
+    erase_batch.reserve(g.num_edges());
+    for(auto ei = g.edges_cbegin(); ei != g.edges_cend(); ++ei)
+      erase_batch.push_back((*ei)->descriptor());
+    for(size_t i = 0; i < quarter_edge; ++i)
+      std::swap(erase_batch[i], erase_batch[i + rand() % (erase_batch.size() - i)]);
+    g.erase_edges(erase_batch.begin(), erase_batch.begin() + quarter_edge);
+    size_t quarter_nodes = g.num_vertices() / 4;
+    for(size_t i = 0; i < quarter_nodes; ++i) {
+      typename graph_id::vertex_iterator vi = g.find_vertex(rand() % g.num_vertices());
+      if(vi != g.vertices_end())
+        g.erase_vertex((*vi)->descriptor());
+      else
+        --i;
+    }
+    end(benchmark_phase::erase);
+  }
+}
+
+
+///@brief Summary of the timings of one phase over its repetitions.
+struct sample_stats {
+  size_t count;   // Number of samples
+  double min;
+  double median;
+  double p95;     // 95th percentile, nearest rank
+  double mean;
+
+  sample_stats() : count(0), min(0), median(0), p95(0), mean(0) { }
+};
+
+inline sample_stats summarize(std::vector<double> samples) {
+  sample_stats s;
+  if(samples.empty())
+    return s;
+  std::sort(samples.begin(), samples.end());
+  size_t n = samples.size();
+  s.count = n;
+  s.min = samples.front();
+  s.median = n % 2 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+  s.p95 = samples[size_t(std::ceil(0.95 * n)) - 1];
+  for(double x : samples)
+    s.mean += x;
+  s.mean /= n;
+  return s;
+}
+
+
+///@brief Restart the peak resident set size of the process from its current
+///       size, so that peak_rss_bytes() covers what follows. Needs Linux
+///       (/proc/self/clear_refs); returns false elsewhere, and the peak then
+///       covers the whole life of the process.
+inline bool reset_peak_rss() {
+  std::ofstream clear_refs("/proc/self/clear_refs");
+  clear_refs << "5";
+  clear_refs.flush();
+  return bool(clear_refs);
+}
+
+///@brief Peak resident set size of the process in bytes, since the last
+///       reset_peak_rss() where supported.
+inline size_t peak_rss_bytes() {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while(std::getline(status, line))
+    if(line.compare(0, 6, "VmHWM:") == 0)
+      return std::strtoull(line.c_str() + 6, nullptr, 10) * 1024;
+  struct rusage usage;
+  if(getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+#ifdef __APPLE__
+  return usage.ru_maxrss;
+#else
+  return size_t(usage.ru_maxrss) * 1024;
+#endif
+}
+
+
+///@brief Result of one phase of one benchmark configuration.
+struct benchmark_record {
+  std::string graph;      // Graph type
+  std::string generator;  // Generator of the input graph
+  size_t size;            // Requested graph size
+  std::string phase;
+  sample_stats stats;     // Seconds per repetition, warmup excluded
+  size_t peak_rss;        // Peak RSS in bytes over the configuration's runs
+  perf_reading counters;  // Median event counts per repetition, if collected
+
+  benchmark_record() : size(0), peak_rss(0) { }
+
+  std::tuple<std::string, std::string, size_t, std::string> key() const {
+    return std::make_tuple(graph, generator, size, phase);
+  }
+};
+
+///@brief Write records as an aligned table.
+inline void write_table(std::ostream& os, const std::vector<benchmark_record>& records) {
+  os << std::left << std::setw(8) << "graph" << std::setw(10) << "generator"
+    << std::setw(9) << "size" << std::setw(8) << "phase" << std::right
+    << std::setw(6) << "reps" << std::setw(13) << "min" << std::setw(13) << "median"
+    << std::setw(13) << "p95" << std::setw(11) << "peak MB" << std::endl;
+  for(auto& r : records)
+    os << std::left << std::setw(8) << r.graph << std::setw(10) << r.generator
+      << std::setw(9) << r.size << std::setw(8) << r.phase << std::right
+      << std::setw(6) << r.stats.count << std::setw(13) << r.stats.min
+      << std::setw(13) << r.stats.median << std::setw(13) << r.stats.p95
+      << std::setw(11) << std::fixed << std::setprecision(1) << r.peak_rss / 1e6
+      << std::defaultfloat << std::setprecision(6)
+      << (r.counters.any() ? "  " : "") << r.counters << std::endl;
+}
+
+///@brief Write records as CSV with a header line. This is the baseline
+///       format read by read_baseline().
+inline void write_csv(std::ostream& os, const std::vector<benchmark_record>& records) {
+  os << "graph,generator,size,phase,reps,min,median,p95,mean,peak_rss_bytes";
+  for(int e = 0; e < num_perf_events; ++e)
+    os << ',' << perf_event_name(perf_event(e));
+  os << std::endl << std::setprecision(9);
+  for(auto& r : records) {
+    os << r.graph << ',' << r.generator << ',' << r.size << ',' << r.phase << ','
+      << r.stats.count << ',' << r.stats.min << ',' << r.stats.median << ','
+      << r.stats.p95 << ',' << r.stats.mean << ',' << r.peak_rss;
+    //uncounted events are left empty
+    for(int e = 0; e < num_perf_events; ++e) {
+      os << ',';
+      if(r.counters.valid[e])
+        os << r.counters.count[e];
+    }
+    os << std::endl;
+  }
+  os << std::setprecision(6);
+}
+
+///@brief Write records as a JSON object with a "benchmarks" array.
+inline void write_json(std::ostream& os, const std::vector<benchmark_record>& records) {
+  os << "{\n  \"benchmarks\": [";
+  os << std::setprecision(9);
+  for(size_t i = 0; i < records.size(); ++i) {
+    const benchmark_record& r = records[i];
+    os << (i ? ",\n" : "\n") << "    {\"graph\": \"" << r.graph
+      << "\", \"generator\": \"" << r.generator << "\", \"size\": " << r.size
+      << ", \"phase\": \"" << r.phase << "\", \"reps\": " << r.stats.count
+      << ", \"min\": " << r.stats.min << ", \"median\": " << r.stats.median
+      << ", \"p95\": " << r.stats.p95 << ", \"mean\": " << r.stats.mean
+      << ", \"peak_rss_bytes\": " << r.peak_rss;
+    if(r.counters.any()) {
+      os << ", \"counters\": {";
+      bool first = true;
+      for(int e = 0; e < num_perf_events; ++e)
+        if(r.counters.valid[e]) {
+          os << (first ? "\"" : ", \"") << perf_event_name(perf_event(e)) << "\": "
+            << r.counters.count[e];
+          first = false;
+        }
+      os << "}";
+    }
+    os << "}";
+  }
+  os << "\n  ]\n}" << std::endl;
+  os << std::setprecision(6);
+}
+
+///@brief Read records written by write_csv(). Returns false if the header
+///       or a line is malformed.
+inline bool read_baseline(std::istream& is, std::vector<benchmark_record>& records) {
+  std::string line;
+  if(!std::getline(is, line) || line.compare(0, 6, "graph,") != 0)
+    return false;
+  while(std::getline(is, line)) {
+    if(line.empty())
+      continue;
+    std::istringstream fields(line);
+    std::vector<std::string> f;
+    std::string field;
+    while(std::getline(fields, field, ','))
+      f.push_back(field);
+    if(f.size() < 10 || f.size() > 10 + num_perf_events)
+      return false;
+    benchmark_record r;
+    r.graph = f[0];
+    r.generator = f[1];
+    r.size = std::strtoull(f[2].c_str(), nullptr, 10);
+    r.phase = f[3];
+    r.stats.count = std::strtoull(f[4].c_str(), nullptr, 10);
+    r.stats.min = std::strtod(f[5].c_str(), nullptr);
+    r.stats.median = std::strtod(f[6].c_str(), nullptr);
+    r.stats.p95 = std::strtod(f[7].c_str(), nullptr);
+    r.stats.mean = std::strtod(f[8].c_str(), nullptr);
+    r.peak_rss = std::strtoull(f[9].c_str(), nullptr, 10);
+    for(size_t e = 0; e + 10 < f.size(); ++e)
+      if(!f[e + 10].empty()) {
+        r.counters.valid[e] = true;
+        r.counters.count[e] = std::strtoull(f[e + 10].c_str(), nullptr, 10);
+      }
+    records.push_back(r);
+  }
+  return true;
+}
+
+///@brief Compare the medians of current against the baseline records with
+///       the same graph, generator, size and phase, writing one line per
+///       pair to report. A phase whose median grew by more than threshold
+///       (0.1 = 10%) is flagged as a slowdown. Returns the number of
+///       slowdowns.
+inline size_t compare_to_baseline(const std::vector<benchmark_record>& current,
+    const std::vector<benchmark_record>& baseline, double threshold,
+    std::ostream& report) {
+  typedef std::tuple<std::string, std::string, size_t, std::string> key_type;
+  std::map<key_type, const benchmark_record*> base;
+  for(auto& r : baseline)
+    base[r.key()] = &r;
+
+  size_t slowdowns = 0;
+  for(auto& r : current) {
+    auto b = base.find(r.key());
+    if(b == base.end()) {
+      report << r.graph << ' ' << r.generator << ' ' << r.size << ' ' << r.phase
+        << ": not in baseline" << std::endl;
+      continue;
+    }
+    double before = b->second->stats.median, after = r.stats.median;
+    double change = before > 0 ? after / before - 1 : 0;
+    bool slower = change > threshold;
+    slowdowns += slower;
+    report << r.graph << ' ' << r.generator << ' ' << r.size << ' ' << r.phase
+      << ": median " << before << " -> " << after << " (" << std::showpos
+      << std::fixed << std::setprecision(1) << change * 100 << "%)"
+      << std::noshowpos << std::defaultfloat << std::setprecision(6)
+      << (slower ? "  SLOWER" : "") << std::endl;
+  }
+  return slowdowns;
+}
+
+#endif
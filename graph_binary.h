@@ -0,0 +1,396 @@
+#ifndef _GRAPH_BINARY_H_
+#define _GRAPH_BINARY_H_
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "graph_algorithms.h"
+#include "graph_csr.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Binary graph file format
+///
+/// A file is a graph_binary_header followed by six arrays, each starting on
+/// an 8-byte boundary:
+///
+///   descriptors  num_vertices    x uint64  live vertex descriptors, ascending
+///   present      num_slots       x uint8   1 if the descriptor is live
+///   properties   num_slots       x V       vertex property by descriptor
+///   offsets      num_slots + 1   x uint64  start of each adjacency range
+///   targets      num_edges       x uint64  edge targets grouped by source
+///   weights      num_edges       x E       edge properties, parallel to targets
+///
+/// i.e. the arrays of a graph_csr, stored so that a mapped file can be read
+/// in place. Properties are stored as raw bytes, so V and E must be trivially
+/// copyable. Files record their byte order and the property sizes, and are
+/// rejected if either does not match the reader.
+////////////////////////////////////////////////////////////////////////////////
+
+/// Version written by save_binary(); bump on any layout change.
+const uint32_t graph_binary_version = 1;
+
+struct graph_binary_header {
+  char magic[8];                  // "GRAPHBIN"
+  uint32_t version;               // graph_binary_version
+  uint32_t byte_order;            // 0x01020304 in the writer's byte order
+  uint32_t vertex_property_size;  // sizeof(V)
+  uint32_t edge_property_size;    // sizeof(E)
+  uint64_t num_slots;             // One past the largest vertex descriptor
+  uint64_t num_vertices;
+  uint64_t num_edges;
+};
+
+///@brief Byte offsets of the arrays of a binary graph file. valid is false
+///       if the header counts are so large that the size does not fit in a
+///       size_t, in which case the offsets are meaningless.
+struct graph_binary_layout {
+  size_t descriptors, present, properties, offsets, targets, weights, size;
+  bool valid;
+
+  graph_binary_layout(const graph_binary_header& h) : valid(true) {
+    size_t at = sizeof(graph_binary_header);
+    descriptors = at; at = align(add(at, mul(h.num_vertices, sizeof(uint64_t))));
+    present = at;     at = align(add(at, h.num_slots));
+    properties = at;  at = align(add(at, mul(h.num_slots, h.vertex_property_size)));
+    offsets = at;     at = align(add(at, mul(add(h.num_slots, 1), sizeof(uint64_t))));
+    targets = at;     at = align(add(at, mul(h.num_edges, sizeof(uint64_t))));
+    weights = at;     at = align(add(at, mul(h.num_edges, h.edge_property_size)));
+    size = at;
+  }
+
+  private:
+    //arithmetic on the header counts, which come from the file; on overflow
+    //the layout is marked invalid
+    size_t add(size_t a, size_t b) {
+      if(a > size_t(-1) - b)
+        valid = false;
+      return a + b;
+    }
+    size_t mul(size_t a, size_t b) {
+      if(b != 0 && a > size_t(-1) / b)
+        valid = false;
+      return a * b;
+    }
+    size_t align(size_t n) {return add(n, 7) & ~size_t(7);}
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// A read-only graph served directly from a memory-mapped binary graph file.
+/// Opening maps the file and validates the header and the arrays (one pass
+/// over descriptors, offsets and targets, so a corrupt file cannot send a
+/// traversal out of bounds); nothing is copied, and the property arrays are
+/// only faulted in as they are read. Has the same interface as graph_csr, so the CSR
+/// traversals (breadth_first_search, depth_first_search) run on it as is.
+////////////////////////////////////////////////////////////////////////////////
+template<typename VertexProperty, typename EdgeProperty>
+class graph_mapped {
+
+  static_assert(sizeof(size_t) == sizeof(uint64_t),
+      "descriptors are mapped in place as 64-bit integers");
+  static_assert(std::is_trivially_copyable<VertexProperty>::value &&
+      std::is_trivially_copyable<EdgeProperty>::value,
+      "properties are stored as raw bytes");
+  static_assert(alignof(VertexProperty) <= 8 && alignof(EdgeProperty) <= 8,
+      "arrays are 8-byte aligned");
+
+  public:
+
+    /// Unique vertex identifier (same as the saved graph)
+    typedef size_t vertex_descriptor;
+
+    /// Unique edge identifier represents pair of vertex descriptors
+    typedef std::pair<size_t, size_t> edge_descriptor;
+
+    // Vertex iterators walk the live descriptors in ascending order
+    typedef const vertex_descriptor* const_vertex_iterator;
+
+    // Adjacency iterators walk the targets of a single vertex
+    typedef const vertex_descriptor* const_adj_iterator;
+    typedef const EdgeProperty* const_weight_iterator;
+
+    ///@brief Constructor. Nothing is mapped until open().
+    graph_mapped() : m_data(nullptr), m_size(0) { reset(); }
+
+    ///@brief Map the file at path, see open().
+    explicit graph_mapped(const std::string& path) : m_data(nullptr), m_size(0) {
+      reset();
+      open(path);
+    }
+
+    ~graph_mapped() { close(); }
+
+    graph_mapped(const graph_mapped&) = delete;             ///< Copy is disabled.
+    graph_mapped& operator=(const graph_mapped&) = delete;  ///< Copy is disabled.
+
+    ///@brief Map a file written by save_binary(). Returns false, leaving
+    ///       nothing mapped, if the file cannot be mapped, is not a complete
+    ///       version graph_binary_version file for these property types, or
+    ///       its arrays are inconsistent (see valid_arrays()).
+    bool open(const std::string& path) {
+      close();
+      int fd = ::open(path.c_str(), O_RDONLY);
+      if(fd < 0)
+        return false;
+      struct stat st;
+      if(fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(graph_binary_header)) {
+        ::close(fd);
+        return false;
+      }
+      void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      ::close(fd);
+      if(data == MAP_FAILED)
+        return false;
+      m_data = static_cast<const char*>(data);
+      m_size = st.st_size;
+
+      graph_binary_header h;
+      std::memcpy(&h, m_data, sizeof(h));
+      graph_binary_layout l(h);
+      if(std::memcmp(h.magic, "GRAPHBIN", 8) != 0 ||
+          h.version != graph_binary_version || h.byte_order != 0x01020304 ||
+          h.vertex_property_size != sizeof(VertexProperty) ||
+          h.edge_property_size != sizeof(EdgeProperty) ||
+          !l.valid || l.size > m_size) {
+        close();
+        return false;
+      }
+
+      m_num_slots = h.num_slots;
+      m_num_vertices = h.num_vertices;
+      m_num_edges = h.num_edges;
+      m_descriptors = reinterpret_cast<const vertex_descriptor*>(m_data + l.descriptors);
+      m_present = reinterpret_cast<const uint8_t*>(m_data + l.present);
+      m_properties = reinterpret_cast<const VertexProperty*>(m_data + l.properties);
+      m_offsets = reinterpret_cast<const uint64_t*>(m_data + l.offsets);
+      m_targets = reinterpret_cast<const vertex_descriptor*>(m_data + l.targets);
+      m_weights = reinterpret_cast<const EdgeProperty*>(m_data + l.weights);
+      if(!valid_arrays()) {
+        close();
+        return false;
+      }
+      return true;
+    }
+
+    ///@brief Unmap the file. The graph is then empty.
+    void close() {
+      if(m_data)
+        munmap(const_cast<char*>(m_data), m_size);
+      m_data = nullptr;
+      m_size = 0;
+      reset();
+    }
+
+    bool is_open() const {return m_data != nullptr;}
+
+    ///@brief Accessors
+    size_t num_vertices() const {return m_num_vertices;}
+    size_t num_edges() const {return m_num_edges;}
+
+    ///@brief One past the largest vertex descriptor. Arrays indexed by
+    ///       descriptor need to have this many entries.
+    size_t num_slots() const {return m_num_slots;}
+
+    bool contains(vertex_descriptor vd) const {
+      return vd < m_num_slots && m_present[vd];
+    }
+
+    const_vertex_iterator vertices_cbegin() const {return m_descriptors;}
+    const_vertex_iterator vertices_cend() const {return m_descriptors + m_num_vertices;}
+
+    ///@brief Adjacency operations. vd must be a vertex of the graph.
+    const_adj_iterator out_begin(vertex_descriptor vd) const {
+      return m_targets + m_offsets[vd];
+    }
+    const_adj_iterator out_end(vertex_descriptor vd) const {
+      return m_targets + m_offsets[vd + 1];
+    }
+    const_weight_iterator weights_begin(vertex_descriptor vd) const {
+      return m_weights + m_offsets[vd];
+    }
+    size_t out_degree(vertex_descriptor vd) const {
+      return m_offsets[vd + 1] - m_offsets[vd];
+    }
+
+    const VertexProperty& property(vertex_descriptor vd) const {
+      return m_properties[vd];
+    }
+
+  private:
+    ///@brief Whether the mapped arrays describe a graph the accessors can
+    ///       serve: descriptors ascending, in range and present, as many
+    ///       present slots as vertices, offsets starting at 0, never
+    ///       decreasing and ending at num_edges, and every target a present
+    ///       vertex.
+    bool valid_arrays() const {
+      size_t present = 0;
+      for(size_t vd = 0; vd < m_num_slots; ++vd)
+        present += m_present[vd] != 0;
+      if(present != m_num_vertices)
+        return false;
+      for(size_t i = 0; i < m_num_vertices; ++i)
+        if(m_descriptors[i] >= m_num_slots || !m_present[m_descriptors[i]] ||
+            (i > 0 && m_descriptors[i] <= m_descriptors[i - 1]))
+          return false;
+      if(m_offsets[0] != 0 || m_offsets[m_num_slots] != m_num_edges)
+        return false;
+      for(size_t vd = 0; vd < m_num_slots; ++vd)
+        if(m_offsets[vd + 1] < m_offsets[vd])
+          return false;
+      for(size_t i = 0; i < m_num_edges; ++i)
+        if(m_targets[i] >= m_num_slots || !m_present[m_targets[i]])
+          return false;
+      return true;
+    }
+
+    ///@brief Point every array at an empty graph.
+    void reset() {
+      static const uint64_t zero = 0;
+      m_num_slots = m_num_vertices = m_num_edges = 0;
+      m_descriptors = m_targets = nullptr;
+      m_present = nullptr;
+      m_properties = nullptr;
+      m_offsets = &zero;
+      m_weights = nullptr;
+    }
+
+    const char* m_data;                       // Mapped file, or nullptr
+    size_t m_size;                            // Length of the mapping
+    size_t m_num_slots;
+    size_t m_num_vertices;
+    size_t m_num_edges;
+    const vertex_descriptor* m_descriptors;   // Live descriptors, ascending
+    const uint8_t* m_present;                 // Whether a descriptor is live
+    const VertexProperty* m_properties;       // Vertex properties by descriptor
+    const uint64_t* m_offsets;                // Start of each adjacency range
+    const vertex_descriptor* m_targets;       // Edge targets, grouped by source
+    const EdgeProperty* m_weights;            // Edge properties, parallel to m_targets
+};
+
+
+///@brief Breadth-first search over a mapped graph file.
+template<typename V, typename E, typename ParentMap>
+void breadth_first_search(const graph_mapped<V, E>& g, ParentMap& p) {
+  csr_breadth_first_search(g, p);
+}
+
+///@brief Depth-first search over a mapped graph file.
+template<typename V, typename E, typename ParentMap>
+void depth_first_search(const graph_mapped<V, E>& g, ParentMap& p) {
+  csr_depth_first_search(g, p);
+}
+
+
+///@brief Write a CSR snapshot to path in the binary graph format. Returns
+///       whether the whole file was written.
+template<typename V, typename E>
+bool save_binary(const graph_csr<V, E>& csr, const std::string& path) {
+  static_assert(std::is_trivially_copyable<V>::value &&
+      std::is_trivially_copyable<E>::value, "properties are stored as raw bytes");
+
+  graph_binary_header h;
+  std::memset(&h, 0, sizeof(h));
+  std::memcpy(h.magic, "GRAPHBIN", 8);
+  h.version = graph_binary_version;
+  h.byte_order = 0x01020304;
+  h.vertex_property_size = sizeof(V);
+  h.edge_property_size = sizeof(E);
+  h.num_slots = csr.num_slots();
+  h.num_vertices = csr.num_vertices();
+  h.num_edges = csr.num_edges();
+  graph_binary_layout l(h);
+
+  std::vector<uint64_t> descriptors(csr.vertices_cbegin(), csr.vertices_cend());
+  std::vector<uint8_t> present(h.num_slots);
+  std::vector<V> properties(h.num_slots);
+  std::vector<uint64_t> offsets(h.num_slots + 1, 0);
+  for(size_t vd = 0; vd < h.num_slots; ++vd) {
+    present[vd] = csr.contains(vd);
+    properties[vd] = csr.property(vd);
+    offsets[vd + 1] = offsets[vd] + csr.out_degree(vd);
+  }
+
+  FILE* f = std::fopen(path.c_str(), "wb");
+  if(!f)
+    return false;
+  size_t at = 0;
+  bool ok = true;
+  //write n bytes at file offset start, zero-filling the gap before it
+  auto put = [&](size_t start, const void* data, size_t n) {
+    static const char zeros[8] = {0};
+    if(at < start)
+      ok = ok && std::fwrite(zeros, 1, start - at, f) == start - at;
+    if(n)
+      ok = ok && std::fwrite(data, 1, n, f) == n;
+    at = start + n;
+  };
+  put(0, &h, sizeof(h));
+  put(l.descriptors, descriptors.data(), descriptors.size() * sizeof(uint64_t));
+  put(l.present, present.data(), present.size());
+  put(l.properties, properties.data(), properties.size() * sizeof(V));
+  put(l.offsets, offsets.data(), offsets.size() * sizeof(uint64_t));
+  //the targets and weights of a snapshot are single arrays starting at
+  //vertex 0's range
+  put(l.targets, h.num_edges ? csr.out_begin(0) : nullptr,
+      h.num_edges * sizeof(uint64_t));
+  put(l.weights, h.num_edges ? csr.weights_begin(0) : nullptr,
+      h.num_edges * sizeof(E));
+  put(l.size, nullptr, 0);
+  return std::fclose(f) == 0 && ok;
+}
+
+///@brief Write g (a graph or a graph_vector) to path in the binary graph
+///       format. Returns whether the whole file was written.
+template<typename Graph>
+bool save_binary(const Graph& g, const std::string& path) {
+  graph_csr<typename Graph::vertex_property, typename Graph::edge_property> csr(g);
+  return save_binary(csr, path);
+}
+
+///@brief Replace the contents of g (a graph or a graph_vector) with the
+///       binary graph file at path. Vertex descriptors are preserved.
+///       Returns false, leaving g untouched, if the file cannot be read.
+template<typename Graph>
+bool load_binary(Graph& g, const std::string& path) {
+  typedef typename Graph::vertex_property V;
+  typedef typename Graph::edge_property E;
+  typedef typename Graph::edge_value edge_value;
+
+  graph_mapped<V, E> m;
+  if(!m.open(path))
+    return false;
+
+  //vertices are inserted for every slot so the descriptors line up, then
+  //the slots that were free in the saved graph are erased again
+  g.clear();
+  std::vector<V> properties(m.num_slots());
+  for(size_t vd = 0; vd < m.num_slots(); ++vd)
+    properties[vd] = m.property(vd);
+  g.insert_vertices(properties.begin(), properties.end());
+  for(size_t vd = 0; vd < m.num_slots(); ++vd)
+    if(!m.contains(vd))
+      g.erase_vertex(vd);
+
+  std::vector<edge_value> edges;
+  edges.reserve(m.num_edges());
+  for(auto vi = m.vertices_cbegin(); vi != m.vertices_cend(); ++vi) {
+    auto w = m.weights_begin(*vi);
+    for(auto ai = m.out_begin(*vi); ai != m.out_end(*vi); ++ai, ++w)
+      edges.emplace_back(std::make_pair(*vi, *ai), *w);
+  }
+  g.insert_edges(edges.begin(), edges.end());
+  return true;
+}
+
+#endif
@@ -0,0 +1,310 @@
+#ifndef _GRAPH_COMPRESSED_H_
+#define _GRAPH_COMPRESSED_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "graph_algorithms.h"
+#include "graph_simd.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// An immutable snapshot of an adjacency-list graph with compressed
+/// adjacency. The targets of every vertex are sorted and stored as a byte
+/// stream of varints (7 bits per byte, high bit set on all but the last
+/// byte): the first target relative to the vertex itself (zigzag encoded,
+/// since it may be smaller), every other one as the gap to its predecessor.
+/// Neighbours in graphs with locality are close in descriptor space, so most
+/// entries take one or two bytes instead of the eight of a vertex_descriptor.
+/// Edge properties are kept uncompressed in a parallel array.
+///
+/// Has the same interface as graph_csr, with an adjacency iterator that
+/// decodes on the fly, so the CSR traversals run on it as is. They go
+/// through for_each_target() instead, which decodes the same way except for
+/// long lists that start with a window of one-byte gaps: those go in blocks
+/// into a small buffer, with runs of one-byte gaps found by SIMD
+/// (simd_decode_gaps in graph_simd.h).
+////////////////////////////////////////////////////////////////////////////////
+template<typename VertexProperty, typename EdgeProperty>
+class graph_compressed {
+
+  public:
+
+    /// Unique vertex identifier (same as the source graph)
+    typedef size_t vertex_descriptor;
+
+    /// Unique edge identifier represents pair of vertex descriptors
+    typedef std::pair<size_t, size_t> edge_descriptor;
+
+    // Vertex iterators walk the live descriptors in ascending order
+    typedef typename std::vector<vertex_descriptor>::const_iterator const_vertex_iterator;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Forward iterator over the targets of one vertex, in ascending order,
+    /// decoding one varint per increment.
+    ////////////////////////////////////////////////////////////////////////////
+    class const_adj_iterator {
+      public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef vertex_descriptor value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const vertex_descriptor* pointer;
+        typedef const vertex_descriptor& reference;
+
+        const_adj_iterator() : m_cur(nullptr), m_next(nullptr), m_end(nullptr),
+          m_value(0) { }
+
+        ///@brief Iterator at the first entry of [cur, end), the list of
+        ///       vertex vd.
+        const_adj_iterator(const uint8_t* cur, const uint8_t* end,
+            vertex_descriptor vd) : m_cur(cur), m_next(cur), m_end(end), m_value(0) {
+          if(m_cur != m_end) {
+            uint64_t z = decode();
+            m_value = vd + (z & 1 ? -(z >> 1) - 1 : z >> 1);
+          }
+        }
+
+        reference operator*() const {return m_value;}
+        pointer operator->() const {return &m_value;}
+
+        const_adj_iterator& operator++() {
+          m_cur = m_next;
+          if(m_cur != m_end)
+            m_value += decode();
+          return *this;
+        }
+        const_adj_iterator operator++(int) {
+          const_adj_iterator tmp = *this;
+          ++*this;
+          return tmp;
+        }
+
+        bool operator==(const const_adj_iterator& o) const {return m_cur == o.m_cur;}
+        bool operator!=(const const_adj_iterator& o) const {return m_cur != o.m_cur;}
+
+      private:
+        ///@brief Decode the varint at m_next and advance m_next past it.
+        uint64_t decode() {
+          uint64_t v = *m_next & 0x7f;
+          for(unsigned shift = 7; *m_next++ & 0x80; shift += 7)
+            v |= uint64_t(*m_next & 0x7f) << shift;
+          return v;
+        }
+
+        const uint8_t* m_cur;       // Encoding of the current target
+        const uint8_t* m_next;      // Encoding of the next target
+        const uint8_t* m_end;       // End of the vertex's list
+        vertex_descriptor m_value;  // Current target
+    };
+
+    typedef const EdgeProperty* const_weight_iterator;
+
+    ///@brief Constructor. An empty snapshot has no vertices.
+    graph_compressed() : m_offsets(1, 0), m_edge_offsets(1, 0) { }
+
+    ///@brief Build a snapshot of g. g can be a graph or a graph_vector.
+    template<typename Graph>
+    explicit graph_compressed(const Graph& g) { build(g); }
+
+    ///@brief Rebuild the snapshot from g, discarding the previous contents.
+    ///       Edges whose target is not a vertex of g are skipped.
+    template<typename Graph>
+    void build(const Graph& g) {
+      typedef typename std::decay<decltype(*g.vertices_cbegin())>::type vertex_ptr;
+      typedef std::pair<vertex_descriptor, vertex_ptr> entry;
+      typedef std::pair<vertex_descriptor, EdgeProperty> target;
+
+      std::vector<entry> verts;
+      verts.reserve(g.num_vertices());
+      for(auto vi = g.vertices_cbegin(); vi != g.vertices_cend(); ++vi)
+        verts.emplace_back((*vi)->descriptor(), *vi);
+      std::sort(verts.begin(), verts.end(),
+          [](const entry& a, const entry& b) {return a.first < b.first;});
+
+      size_t slots = verts.empty() ? 0 : verts.back().first + 1;
+      m_vertices.clear();
+      m_vertices.reserve(verts.size());
+      m_present.assign(slots, false);
+      m_properties.assign(slots, VertexProperty());
+      for(auto& v : verts) {
+        m_vertices.push_back(v.first);
+        m_present[v.first] = true;
+        m_properties[v.first] = v.second->property();
+      }
+
+      m_offsets.assign(slots + 1, 0);
+      m_edge_offsets.assign(slots + 1, 0);
+      m_bytes.clear();
+      m_weights.clear();
+      m_weights.reserve(g.num_edges());
+      std::vector<target> targets;
+      size_t vd = 0;
+      for(auto& v : verts) {
+        for(; vd <= v.first; ++vd) {
+          m_offsets[vd] = m_bytes.size();
+          m_edge_offsets[vd] = m_weights.size();
+        }
+        targets.clear();
+        for(auto aei = v.second->cbegin(); aei != v.second->cend(); ++aei) {
+          vertex_descriptor t = (*aei)->target();
+          if(t < slots && m_present[t])
+            targets.emplace_back(t, (*aei)->property());
+        }
+        std::sort(targets.begin(), targets.end(),
+            [](const target& a, const target& b) {return a.first < b.first;});
+        vertex_descriptor prev = v.first;
+        for(size_t i = 0; i < targets.size(); ++i) {
+          vertex_descriptor t = targets[i].first;
+          if(i == 0)
+            encode(t >= prev ? (t - prev) << 1 : ((prev - t - 1) << 1) | 1);
+          else
+            encode(t - prev);
+          prev = t;
+          m_weights.push_back(targets[i].second);
+        }
+      }
+      for(; vd <= slots; ++vd) {
+        m_offsets[vd] = m_bytes.size();
+        m_edge_offsets[vd] = m_weights.size();
+      }
+      m_bytes.shrink_to_fit();
+    }
+
+    ///@brief Accessors
+    size_t num_vertices() const {return m_vertices.size();}
+    size_t num_edges() const {return m_weights.size();}
+
+    ///@brief One past the largest vertex descriptor. Arrays indexed by
+    ///       descriptor need to have this many entries.
+    size_t num_slots() const {return m_present.size();}
+
+    bool contains(vertex_descriptor vd) const {
+      return vd < m_present.size() && m_present[vd];
+    }
+
+    const_vertex_iterator vertices_cbegin() const {return m_vertices.cbegin();}
+    const_vertex_iterator vertices_cend() const {return m_vertices.cend();}
+
+    ///@brief Adjacency operations. vd must be a vertex of the snapshot.
+    ///       Targets come in ascending order.
+    const_adj_iterator out_begin(vertex_descriptor vd) const {
+      return const_adj_iterator(m_bytes.data() + m_offsets[vd],
+          m_bytes.data() + m_offsets[vd + 1], vd);
+    }
+    const_adj_iterator out_end(vertex_descriptor vd) const {
+      const uint8_t* end = m_bytes.data() + m_offsets[vd + 1];
+      return const_adj_iterator(end, end, vd);
+    }
+    const_weight_iterator weights_begin(vertex_descriptor vd) const {
+      return m_weights.data() + m_edge_offsets[vd];
+    }
+    size_t out_degree(vertex_descriptor vd) const {
+      return m_edge_offsets[vd + 1] - m_edge_offsets[vd];
+    }
+
+    const VertexProperty& property(vertex_descriptor vd) const {
+      return m_properties[vd];
+    }
+
+    ///@brief Call f(t) for every target t of vd, in ascending order,
+    ///       decoding one varint at a time as the iterator does. Only a list
+    ///       of decode_block bytes or more whose first SIMD window after the
+    ///       first target is all one-byte gaps (window_is_one_byte()) is
+    ///       decoded decode_block targets at a time into a buffer on the
+    ///       stack with simd_decode_gaps(); elsewhere the windows do not pay
+    ///       off.
+    template<typename F>
+    void for_each_target(vertex_descriptor vd, F f) const {
+      const uint8_t* p = m_bytes.data() + m_offsets[vd];
+      const uint8_t* end = m_bytes.data() + m_offsets[vd + 1];
+      if(p == end)
+        return;
+      uint64_t z = varint(p);
+      vertex_descriptor t = vd + (z & 1 ? -(z >> 1) - 1 : z >> 1);
+      f(t);
+      if(size_t(end - p) < decode_block || !window_is_one_byte(p)) {
+        while(p != end)
+          f(t += varint(p));
+        return;
+      }
+      vertex_descriptor block[decode_block];
+      while(p != end) {
+        size_t n = simd_decode_gaps(p, end, t, block, decode_block);
+        for(size_t i = 0; i < n; ++i)
+          f(block[i]);
+      }
+    }
+
+    ///@brief Size of the encoded adjacency, and per edge. A graph_csr
+    ///       spends sizeof(vertex_descriptor) bytes per edge on the same.
+    size_t adjacency_bytes() const {return m_bytes.size();}
+    double adjacency_bytes_per_edge() const {
+      return num_edges() ? double(m_bytes.size()) / num_edges() : 0;
+    }
+
+    ///@brief Bytes held by the snapshot, and per edge.
+    size_t memory_bytes() const {
+      return m_vertices.capacity() * sizeof(vertex_descriptor) +
+        m_present.capacity() / 8 +
+        m_properties.capacity() * sizeof(VertexProperty) +
+        (m_offsets.capacity() + m_edge_offsets.capacity()) * sizeof(uint64_t) +
+        m_bytes.capacity() + m_weights.capacity() * sizeof(EdgeProperty);
+    }
+    double bytes_per_edge() const {
+      return num_edges() ? double(memory_bytes()) / num_edges() : 0;
+    }
+
+  private:
+    static const size_t decode_block = 64;   // Targets per block, and bytes of the shortest list in blocks
+
+    ///@brief Decode the varint at p and advance p past it.
+    static uint64_t varint(const uint8_t*& p) {
+      uint64_t v = *p & 0x7f;
+      for(unsigned shift = 7; *p++ & 0x80; shift += 7)
+        v |= uint64_t(*p & 0x7f) << shift;
+      return v;
+    }
+
+    ///@brief Append v to the byte stream as a varint.
+    void encode(uint64_t v) {
+      while(v >= 0x80) {
+        m_bytes.push_back(uint8_t(v) | 0x80);
+        v >>= 7;
+      }
+      m_bytes.push_back(uint8_t(v));
+    }
+
+    std::vector<vertex_descriptor> m_vertices;  // Live descriptors, ascending
+    std::vector<bool> m_present;                // Whether a descriptor is live
+    std::vector<VertexProperty> m_properties;   // Vertex properties by descriptor
+    std::vector<uint64_t> m_offsets;            // Start of each list in m_bytes
+    std::vector<uint64_t> m_edge_offsets;       // Start of each list in m_weights
+    std::vector<uint8_t> m_bytes;               // Varint-encoded target lists
+    std::vector<EdgeProperty> m_weights;        // Edge properties, by list position
+};
+
+
+///@brief Enumerate the targets of vd with for_each_target(); found by the
+///       CSR traversals in place of the iterator loop.
+template<typename V, typename E, typename F>
+void csr_for_each_target(const graph_compressed<V, E>& g, size_t vd, F f) {
+  g.for_each_target(vd, f);
+}
+
+///@brief Breadth-first search over a compressed snapshot.
+template<typename V, typename E, typename ParentMap>
+void breadth_first_search(const graph_compressed<V, E>& g, ParentMap& p) {
+  csr_breadth_first_search(g, p);
+}
+
+///@brief Depth-first search over a compressed snapshot.
+template<typename V, typename E, typename ParentMap>
+void depth_first_search(const graph_compressed<V, E>& g, ParentMap& p) {
+  csr_depth_first_search(g, p);
+}
+
+#endif
@@ -0,0 +1,499 @@
+#ifndef _GRAPH_CONCURRENT_H_
+#define _GRAPH_CONCURRENT_H_
+
+#include <atomic>
+#include <iterator>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "graph_arena.h"
+#include "graph_hash_set.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Slots of T* indexed by descriptor that grow without ever moving, so slots
+/// can be read while other threads add new ones. Segment k holds
+/// 2^(first_bits + k) slots and is allocated on first use, the race between
+/// two threads allocating it settled by compare-and-swap. get() is two
+/// acquire loads; set() publishes with a release store.
+////////////////////////////////////////////////////////////////////////////////
+template<typename T>
+class concurrent_slot_map {
+
+  public:
+
+    enum : size_t {
+      first_bits = 6,                   ///< Segment 0 has 2^first_bits slots
+      num_segments = 64 - first_bits
+    };
+
+    concurrent_slot_map() {
+      for(auto& s : m_segments)
+        s.store(nullptr, std::memory_order_relaxed);
+    }
+
+    ~concurrent_slot_map() {
+      clear();
+    }
+
+    concurrent_slot_map(const concurrent_slot_map&) = delete;             ///< Copy is disabled.
+    concurrent_slot_map& operator=(const concurrent_slot_map&) = delete;  ///< Copy is disabled.
+
+    ///@brief Object stored for key k, or nullptr if there is none.
+    T* get(size_t k) const {
+      size_t seg, off;
+      locate(k, seg, off);
+      std::atomic<T*>* s = m_segments[seg].load(std::memory_order_acquire);
+      return s ? s[off].load(std::memory_order_acquire) : nullptr;
+    }
+
+    ///@brief Store t (or nullptr, to tombstone the slot) under key k.
+    void set(size_t k, T* t) {
+      size_t seg, off;
+      locate(k, seg, off);
+      std::atomic<T*>* s = m_segments[seg].load(std::memory_order_acquire);
+      if(!s) {
+        std::atomic<T*>* fresh = new std::atomic<T*>[size_t(1) << (seg + first_bits)]();
+        if(m_segments[seg].compare_exchange_strong(s, fresh, std::memory_order_acq_rel))
+          s = fresh;
+        else
+          delete[] fresh;
+      }
+      s[off].store(t, std::memory_order_release);
+    }
+
+    ///@brief Free every segment. Not thread-safe.
+    void clear() {
+      for(auto& s : m_segments)
+        delete[] s.exchange(nullptr);
+    }
+
+  private:
+    static void locate(size_t k, size_t& seg, size_t& off) {
+      size_t j = k + (size_t(1) << first_bits);
+      seg = 63 - __builtin_clzll(j) - first_bits;
+      off = j - (size_t(1) << (seg + first_bits));
+    }
+
+    std::atomic<std::atomic<T*>*> m_segments[num_segments];
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// A graph that several threads can fill at once. It has the vertex, edge
+/// and adjacency interface of graph, so the algorithms run on it unchanged
+/// once the writers are done.
+///
+/// Descriptors are handed out by an atomic counter and vertices live in a
+/// concurrent_slot_map, so find_vertex() takes no lock. Everything else is
+/// sharded by vertex: shard vd % num_shards owns a mutex, which guards the
+/// adjacency lists of its vertices, and a slab_arena, from which those
+/// vertices, their out-edges and their adjacency containers are allocated.
+/// An edge operation locks the shards of its two endpoints (in shard order,
+/// so two writers cannot deadlock), so writers only contend when they touch
+/// vertices of the same shard. There is no global edge index: an edge is
+/// found through the out-list of its source.
+///
+/// insert_vertex(), insert_vertices(), insert_edge(), insert_edges(),
+/// erase_edge(), erase_vertex(), has_edge(), find_edge_property(),
+/// find_vertex(), num_vertices() and num_edges() are thread-safe.
+/// erase_vertex() locks every shard and so pauses all other writers.
+/// Iterators, adjacency lists and clear() require that no thread is
+/// modifying the graph.
+////////////////////////////////////////////////////////////////////////////////
+template<typename VertexProperty, typename EdgeProperty>
+class concurrent_graph {
+
+  class vertex;
+  class edge;
+
+  struct edge_key;
+
+  public:
+
+    /// Unique vertex identifier
+    typedef size_t vertex_descriptor;
+
+    /// Unique edge identifier represents pair of vertex descriptors
+    typedef std::pair<size_t, size_t> edge_descriptor;
+
+    /// Property types, e.g. to build batches for insert_vertices()
+    typedef VertexProperty vertex_property;
+    typedef EdgeProperty edge_property;
+
+    /// An edge to be added by insert_edges(): its descriptor and property
+    typedef std::pair<edge_descriptor, EdgeProperty> edge_value;
+
+    ///@brief A container for the adjacency lists, allocating from the arena
+    ///       of the vertex's shard.
+    typedef open_hash_set<edge, edge_descriptor, edge_key, pair_hash,
+            arena_allocator<edge*, slab_arena>> MyAdjEdgeContainer;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Forward iterator over the live vertices in descriptor order,
+    /// dereferencing to vertex*.
+    ////////////////////////////////////////////////////////////////////////////
+    class const_vertex_iterator {
+      public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef vertex* value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef vertex* const* pointer;
+        typedef vertex* reference;
+
+        const_vertex_iterator() : m_slots(nullptr), m_cur(0), m_end(0) { }
+        const_vertex_iterator(const concurrent_slot_map<vertex>* slots, size_t cur,
+            size_t end) : m_slots(slots), m_cur(cur), m_end(end) {
+          skip();
+        }
+
+        reference operator*() const {return m_slots->get(m_cur);}
+
+        const_vertex_iterator& operator++() {
+          ++m_cur;
+          skip();
+          return *this;
+        }
+        const_vertex_iterator operator++(int) {
+          const_vertex_iterator tmp = *this;
+          ++*this;
+          return tmp;
+        }
+
+        bool operator==(const const_vertex_iterator& o) const {return m_cur == o.m_cur;}
+        bool operator!=(const const_vertex_iterator& o) const {return m_cur != o.m_cur;}
+
+      private:
+        void skip() {
+          while(m_cur < m_end && !m_slots->get(m_cur))
+            ++m_cur;
+        }
+
+        const concurrent_slot_map<vertex>* m_slots;
+        size_t m_cur;  // Current descriptor
+        size_t m_end;  // One past the last descriptor handed out
+    };
+
+    typedef const_vertex_iterator vertex_iterator;
+
+    // Adjacency list iterators
+    typedef typename MyAdjEdgeContainer::iterator adj_edge_iterator;
+    typedef typename MyAdjEdgeContainer::const_iterator const_adj_edge_iterator;
+
+    enum : size_t {default_shards = 256};
+
+    ///@brief Constructor/destructor. num_shards is rounded up to a power of
+    ///       two; more shards mean less contention and more arenas.
+    explicit concurrent_graph(size_t num_shards = default_shards) :
+      m_shards(round_up(num_shards)), m_mask(m_shards.size() - 1),
+      m_next_vd(0), m_num_vertices(0), m_num_edges(0) { }
+
+    ~concurrent_graph() {
+      clear();
+    }
+
+    concurrent_graph(const concurrent_graph&) = delete;             ///< Copy is disabled.
+    concurrent_graph& operator=(const concurrent_graph&) = delete;  ///< Copy is disabled.
+
+    ///@brief vertex iterator operations
+    const_vertex_iterator vertices_begin() const {return vertices_cbegin();}
+    const_vertex_iterator vertices_cbegin() const {
+      return const_vertex_iterator(&m_vertices, 0, m_next_vd.load(std::memory_order_acquire));
+    }
+    const_vertex_iterator vertices_end() const {return vertices_cend();}
+    const_vertex_iterator vertices_cend() const {
+      size_t end = m_next_vd.load(std::memory_order_acquire);
+      return const_vertex_iterator(&m_vertices, end, end);
+    }
+
+    ///@brief Define accessors
+    size_t num_vertices() const {return m_num_vertices.load(std::memory_order_relaxed);}
+    size_t num_edges() const {return m_num_edges.load(std::memory_order_relaxed);}
+    size_t num_shards() const {return m_shards.size();}
+
+    const_vertex_iterator find_vertex(vertex_descriptor vd) const {
+      return m_vertices.get(vd) ? const_vertex_iterator(&m_vertices, vd,
+          m_next_vd.load(std::memory_order_acquire)) : vertices_cend();
+    }
+
+    ///@brief Whether the edge ed is in the graph.
+    bool has_edge(edge_descriptor ed) const {
+      std::lock_guard<std::mutex> lock(shard_of(ed.first).lock);
+      vertex* v = m_vertices.get(ed.first);
+      return v && v->m_out_edges.count(ed);
+    }
+
+    ///@brief Copy the property of edge ed to ep. Returns false, leaving ep
+    ///       alone, if there is no such edge.
+    bool find_edge_property(edge_descriptor ed, EdgeProperty& ep) const {
+      std::lock_guard<std::mutex> lock(shard_of(ed.first).lock);
+      vertex* v = m_vertices.get(ed.first);
+      if(!v)
+        return false;
+      auto ei = v->m_out_edges.find(ed);
+      if(ei == v->m_out_edges.end())
+        return false;
+      ep = (*ei)->property();
+      return true;
+    }
+
+    ///@brief Modifiers
+    vertex_descriptor insert_vertex(const VertexProperty& vp) {
+      vertex_descriptor vd = m_next_vd.fetch_add(1);
+      publish_vertex(vd, vp);
+      return vd;
+    }
+
+    ///@brief Insert a range of VertexProperty values. The new vertices get
+    ///       consecutive descriptors, reserved with a single atomic add even
+    ///       when other threads insert at the same time; returns the first.
+    template<typename InputIterator>
+    vertex_descriptor insert_vertices(InputIterator first, InputIterator last) {
+      std::vector<VertexProperty> props(first, last);
+      vertex_descriptor start = m_next_vd.fetch_add(props.size());
+      for(size_t i = 0; i < props.size(); ++i)
+        publish_vertex(start + i, props[i]);
+      return start;
+    }
+
+    ///@brief Insert the edge sd->td. Returns false, inserting nothing, if it
+    ///       is already in the graph or an endpoint is missing.
+    bool insert_edge(vertex_descriptor sd, vertex_descriptor td,
+        const EdgeProperty& ep) {
+      shard_pair_lock lock(*this, sd, td);
+      vertex* src_v = m_vertices.get(sd);
+      vertex* targ_v = m_vertices.get(td);
+      if(!src_v || !targ_v || src_v->m_out_edges.count(edge_descriptor(sd, td)))
+        return false;
+      edge* e = create<edge>(shard_of(sd), sd, td, ep);
+      src_v->m_out_edges.insert(e);
+      targ_v->m_in_edges.insert(e);
+      m_num_edges.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+
+    void insert_edge_undirected(vertex_descriptor sd, vertex_descriptor td,
+        const EdgeProperty& ep) {
+      insert_edge(sd, td, ep);
+      insert_edge(td, sd, ep);
+    }
+
+    ///@brief Insert a range of edge_value, each as by insert_edge(). Returns
+    ///       the number of edges inserted.
+    template<typename InputIterator>
+    size_t insert_edges(InputIterator first, InputIterator last) {
+      size_t inserted = 0;
+      for(; first != last; ++first)
+        inserted += insert_edge(first->first.first, first->first.second, first->second);
+      return inserted;
+    }
+
+    ///@brief Erase the edge ed. Returns whether it was in the graph.
+    bool erase_edge(edge_descriptor ed) {
+      shard_pair_lock lock(*this, ed.first, ed.second);
+      vertex* src_v = m_vertices.get(ed.first);
+      if(!src_v)
+        return false;
+      auto ei = src_v->m_out_edges.find(ed);
+      if(ei == src_v->m_out_edges.end())
+        return false;
+      edge* e = *ei;
+      src_v->m_out_edges.erase(ei);
+      m_vertices.get(ed.second)->m_in_edges.erase(ed);
+      destroy(shard_of(ed.first), e);
+      m_num_edges.fetch_sub(1, std::memory_order_relaxed);
+      return true;
+    }
+
+    ///@brief Erase vertex vd and its edges. Returns whether it was in the
+    ///       graph. Its edges may belong to any shard, so every shard is
+    ///       locked for the duration.
+    bool erase_vertex(vertex_descriptor vd) {
+      std::vector<std::unique_lock<std::mutex>> locks;
+      locks.reserve(m_shards.size());
+      for(auto& s : m_shards)
+        locks.emplace_back(s.lock);
+
+      vertex* erase_v = m_vertices.get(vd);
+      if(!erase_v)
+        return false;
+      size_t erased = 0;
+      //self-loops are left to the outgoing pass, which sees them too
+      for(auto e : erase_v->m_in_edges) {
+        if(e->source() == vd)
+          continue;
+        m_vertices.get(e->source())->m_out_edges.erase(e);
+        destroy(shard_of(e->source()), e);
+        ++erased;
+      }
+      for(auto e : erase_v->m_out_edges) {
+        if(e->target() != vd)
+          m_vertices.get(e->target())->m_in_edges.erase(e);
+        destroy(shard_of(vd), e);
+        ++erased;
+      }
+      m_vertices.set(vd, nullptr);
+      destroy(shard_of(vd), erase_v);
+      m_num_edges.fetch_sub(erased, std::memory_order_relaxed);
+      m_num_vertices.fetch_sub(1, std::memory_order_relaxed);
+      return true;
+    }
+
+    ///@brief Erase every vertex and edge. Not thread-safe. The shard arenas
+    ///       keep their memory for reuse.
+    void clear() {
+      size_t end = m_next_vd.load();
+      for(size_t vd = 0; vd < end; ++vd)
+        if(vertex* v = m_vertices.get(vd))
+          for(auto e : v->m_out_edges)
+            destroy(shard_of(vd), e);
+      for(size_t vd = 0; vd < end; ++vd)
+        if(vertex* v = m_vertices.get(vd))
+          destroy(shard_of(vd), v);
+      m_vertices.clear();
+      m_next_vd = 0;
+      m_num_vertices = 0;
+      m_num_edges = 0;
+    }
+
+  private:
+    ////////////////////////////////////////////////////////////////////////////
+    /// Lock and arena of the vertices vd with vd % num_shards equal to its
+    /// index. Padded so that neighbouring locks do not share a cache line.
+    ////////////////////////////////////////////////////////////////////////////
+    struct shard {
+      std::mutex lock;
+      slab_arena arena;
+      char padding[64];
+    };
+
+    ///@brief Holds the locks of the shards of two vertices, taken in shard
+    ///       order.
+    class shard_pair_lock {
+      public:
+        shard_pair_lock(const concurrent_graph& g, vertex_descriptor a, vertex_descriptor b) {
+          size_t i = a & g.m_mask, j = b & g.m_mask;
+          m_first = &g.m_shards[std::min(i, j)].lock;
+          m_second = i == j ? nullptr : &g.m_shards[std::max(i, j)].lock;
+          m_first->lock();
+          if(m_second)
+            m_second->lock();
+        }
+
+        ~shard_pair_lock() {
+          if(m_second)
+            m_second->unlock();
+          m_first->unlock();
+        }
+
+        shard_pair_lock(const shard_pair_lock&) = delete;
+        shard_pair_lock& operator=(const shard_pair_lock&) = delete;
+
+      private:
+        std::mutex* m_first;
+        std::mutex* m_second;
+    };
+
+    static size_t round_up(size_t n) {
+      size_t p = 1;
+      while(p < n)
+        p *= 2;
+      return p;
+    }
+
+    shard& shard_of(vertex_descriptor vd) const {return m_shards[vd & m_mask];}
+
+    void publish_vertex(vertex_descriptor vd, const VertexProperty& vp) {
+      shard& s = shard_of(vd);
+      std::lock_guard<std::mutex> lock(s.lock);
+      m_vertices.set(vd, create<vertex>(s, vd, vp, &s.arena));
+      m_num_vertices.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    ///@brief Construct a node of type T in memory drawn from the arena of s,
+    ///       whose lock the caller holds.
+    template<typename T, typename... Args>
+    static T* create(shard& s, Args&&... args) {
+      void* p = s.arena.allocate(sizeof(T));
+      return new(p) T(std::forward<Args>(args)...);
+    }
+
+    ///@brief Destroy a node made by create() and hand its memory back.
+    template<typename T>
+    static void destroy(shard& s, T* t) {
+      t->~T();
+      s.arena.deallocate(t, sizeof(T));
+    }
+
+    mutable std::vector<shard> m_shards;       //< Locks and arenas, declared first so they go last
+    size_t m_mask;                             //< num_shards - 1
+    concurrent_slot_map<vertex> m_vertices;    //< Contains all vertices
+    std::atomic<size_t> m_next_vd;             //< Next vertex descriptor to hand out
+    std::atomic<size_t> m_num_vertices;        //< Live vertices
+    std::atomic<size_t> m_num_edges;           //< Live edges
+
+    class vertex {
+        public:
+          ///required constructors/destructors
+          vertex(vertex_descriptor vd, const VertexProperty& v, slab_arena* a) :
+            m_descriptor(vd), m_property(v),
+            m_out_edges(arena_allocator<edge*, slab_arena>(a)),
+            m_in_edges(arena_allocator<edge*, slab_arena>(a)) { }
+
+          //iterators
+          adj_edge_iterator begin() {return m_out_edges.begin();}
+          const_adj_edge_iterator cbegin() const {return m_out_edges.cbegin();}
+          adj_edge_iterator end() {return m_out_edges.end();}
+          const_adj_edge_iterator cend() const {return m_out_edges.cend();}
+
+          //incoming edge iterators
+          adj_edge_iterator in_begin() {return m_in_edges.begin();}
+          const_adj_edge_iterator in_cbegin() const {return m_in_edges.cbegin();}
+          adj_edge_iterator in_end() {return m_in_edges.end();}
+          const_adj_edge_iterator in_cend() const {return m_in_edges.cend();}
+
+          //accessors
+          size_t out_degree() const {return m_out_edges.size();}
+          size_t in_degree() const {return m_in_edges.size();}
+          const vertex_descriptor descriptor() const {return m_descriptor;}
+          VertexProperty& property() {return m_property;}
+          const VertexProperty& property() const {return m_property;}
+
+        private:
+          vertex_descriptor m_descriptor; // Unique id for the vertex - assigned during insertion
+          VertexProperty m_property;      // Label or property of the vertex - passed during insertion
+          MyAdjEdgeContainer m_out_edges; // Outgoing edges, guarded by the vertex's shard
+          MyAdjEdgeContainer m_in_edges;  // Incoming edges, guarded by the vertex's shard
+          friend class concurrent_graph;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Edges represent the connections between nodes in the graph.
+    ////////////////////////////////////////////////////////////////////////////
+    class edge {
+      public:
+        edge(vertex_descriptor s, vertex_descriptor t,
+              const EdgeProperty& w) : m_source(s), m_target(t), m_property(w) { }
+
+        //accessors
+        const vertex_descriptor source() const {return m_source;}
+        const vertex_descriptor target() const {return m_target;}
+        const edge_descriptor descriptor() const {return {m_source, m_target};}
+        EdgeProperty& property() {return m_property;}
+        const EdgeProperty& property() const {return m_property;}
+
+      private:
+        vertex_descriptor m_source; // Unique id of the source vertex
+        vertex_descriptor m_target; // Unique id of the target vertex
+        EdgeProperty m_property;    // Label or weight of the edge
+    };
+
+    struct edge_key {
+      edge_descriptor operator()(const edge* e) const {
+        return e->descriptor();
+      }
+    };
+};
+
+#endif
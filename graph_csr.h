@@ -0,0 +1,133 @@
+#ifndef _GRAPH_CSR_H_
+#define _GRAPH_CSR_H_
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// An immutable compressed sparse row (CSR) snapshot of an adjacency-list
+/// graph. The out-edges of every vertex are stored contiguously in
+/// m_targets/m_weights, and m_offsets[vd]..m_offsets[vd+1] is the range that
+/// belongs to vertex vd. Descriptors are the same as in the source graph, so
+/// parent maps produced on the snapshot can be used with the original graph.
+////////////////////////////////////////////////////////////////////////////////
+template<typename VertexProperty, typename EdgeProperty>
+class graph_csr {
+
+  public:
+
+    /// Unique vertex identifier (same as the source graph)
+    typedef size_t vertex_descriptor;
+
+    /// Unique edge identifier represents pair of vertex descriptors
+    typedef std::pair<size_t, size_t> edge_descriptor;
+
+    // Vertex iterators walk the live descriptors in ascending order
+    typedef typename std::vector<vertex_descriptor>::const_iterator const_vertex_iterator;
+
+    // Adjacency iterators walk the targets of a single vertex
+    typedef const vertex_descriptor* const_adj_iterator;
+    typedef const EdgeProperty* const_weight_iterator;
+
+    ///@brief Constructor. An empty snapshot has no vertices.
+    graph_csr() : m_offsets(1, 0) { }
+
+    ///@brief Build a snapshot of g. g can be a graph or a graph_vector.
+    template<typename Graph>
+    explicit graph_csr(const Graph& g) { build(g); }
+
+    ///@brief Rebuild the snapshot from g, discarding the previous contents.
+    ///
+    /// The vertices are visited once to record descriptors and properties and
+    /// the out-edges are then copied in a single pass in descriptor order.
+    /// Edges whose target is not a vertex of g are skipped.
+    template<typename Graph>
+    void build(const Graph& g) {
+      typedef typename std::decay<decltype(*g.vertices_cbegin())>::type vertex_ptr;
+      typedef std::pair<vertex_descriptor, vertex_ptr> entry;
+
+      std::vector<entry> verts;
+      verts.reserve(g.num_vertices());
+      for(auto vi = g.vertices_cbegin(); vi != g.vertices_cend(); ++vi)
+        verts.emplace_back((*vi)->descriptor(), *vi);
+      std::sort(verts.begin(), verts.end(),
+          [](const entry& a, const entry& b) {return a.first < b.first;});
+
+      size_t slots = verts.empty() ? 0 : verts.back().first + 1;
+      m_vertices.clear();
+      m_vertices.reserve(verts.size());
+      m_present.assign(slots, false);
+      m_properties.assign(slots, VertexProperty());
+      for(auto& v : verts) {
+        m_vertices.push_back(v.first);
+        m_present[v.first] = true;
+        m_properties[v.first] = v.second->property();
+      }
+
+      m_offsets.assign(slots + 1, 0);
+      m_targets.clear();
+      m_weights.clear();
+      m_targets.reserve(g.num_edges());
+      m_weights.reserve(g.num_edges());
+      size_t vd = 0;
+      for(auto& v : verts) {
+        for(; vd <= v.first; ++vd)
+          m_offsets[vd] = m_targets.size();
+        for(auto aei = v.second->cbegin(); aei != v.second->cend(); ++aei) {
+          vertex_descriptor t = (*aei)->target();
+          if(t < slots && m_present[t]) {
+            m_targets.push_back(t);
+            m_weights.push_back((*aei)->property());
+          }
+        }
+      }
+      for(; vd <= slots; ++vd)
+        m_offsets[vd] = m_targets.size();
+    }
+
+    ///@brief Accessors
+    size_t num_vertices() const {return m_vertices.size();}
+    size_t num_edges() const {return m_targets.size();}
+
+    ///@brief One past the largest vertex descriptor. Arrays indexed by
+    ///       descriptor need to have this many entries.
+    size_t num_slots() const {return m_present.size();}
+
+    bool contains(vertex_descriptor vd) const {
+      return vd < m_present.size() && m_present[vd];
+    }
+
+    const_vertex_iterator vertices_cbegin() const {return m_vertices.cbegin();}
+    const_vertex_iterator vertices_cend() const {return m_vertices.cend();}
+
+    ///@brief Adjacency operations. vd must be a vertex of the snapshot.
+    const_adj_iterator out_begin(vertex_descriptor vd) const {
+      return m_targets.data() + m_offsets[vd];
+    }
+    const_adj_iterator out_end(vertex_descriptor vd) const {
+      return m_targets.data() + m_offsets[vd + 1];
+    }
+    const_weight_iterator weights_begin(vertex_descriptor vd) const {
+      return m_weights.data() + m_offsets[vd];
+    }
+    size_t out_degree(vertex_descriptor vd) const {
+      return m_offsets[vd + 1] - m_offsets[vd];
+    }
+
+    const VertexProperty& property(vertex_descriptor vd) const {
+      return m_properties[vd];
+    }
+
+  private:
+    std::vector<vertex_descriptor> m_vertices;  // Live descriptors, ascending
+    std::vector<bool> m_present;                // Whether a descriptor is live
+    std::vector<VertexProperty> m_properties;   // Vertex properties by descriptor
+    std::vector<size_t> m_offsets;              // Start of each adjacency range
+    std::vector<vertex_descriptor> m_targets;   // Edge targets, grouped by source
+    std::vector<EdgeProperty> m_weights;        // Edge properties, parallel to m_targets
+};
+
+#endif
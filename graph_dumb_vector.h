@@ -2,12 +2,35 @@
 #define _GRAPH_VECTOR_H_
 
 #include <algorithm>
+#include <cassert>
 #include <iostream>
 #include <memory>
+#include <type_traits>
 #include <vector>
 
-
-template<typename VertexProperty, typename EdgeProperty>
+#include "graph_arena.h"
+#include "graph_simd.h"
+
+
+//policies of graph_vector. With vector_aos, find_vertex and find_edge walk the
+//vectors of pointers and dereference each element to compare descriptors, and
+//erasing shifts the tail of the vectors.
+//vector_soa additionally keeps the vertex descriptors and the edge
+//source/target pairs in contiguous arrays parallel to those vectors, so the
+//lookups become SIMD scans of plain integers (see graph_simd.h) at the cost
+//of 8 bytes per vertex and 16 per edge.
+//vector_sorted keeps a descriptor->slot index for vertices and the slot of
+//every edge in the edge itself, and keeps each adjacency list sorted (out-edges
+//by target, in-edges by source). find_vertex is then an array access,
+//find_edge a binary search of the source's out-edges, and erasing moves the
+//last vertex or edge into the hole (swap-and-pop) instead of shifting, so
+//vertices and edges are no longer iterated in insertion order.
+struct vector_aos {};
+struct vector_soa {};
+struct vector_sorted {};
+
+template<typename VertexProperty, typename EdgeProperty,
+         typename Policy = vector_aos>
   class graph_vector {
 
     //you have to forward declare these so you can use them in the public
@@ -25,9 +48,18 @@ template<typename VertexProperty, typename EdgeProperty>
                                                     //represents pair of vertex
                                                     //descriptors
 
-      typedef std::vector<vertex*> vertex_storage;
-      typedef std::vector<edge*> edge_storage;
-      typedef std::vector<edge*> adj_edge_storage;
+      typedef VertexProperty vertex_property; //property types, e.g. to build
+      typedef EdgeProperty edge_property;     //batches for insert_vertices()
+
+      typedef std::pair<edge_descriptor, EdgeProperty> edge_value; //an edge
+                                                    //for insert_edges()
+
+      //every vector allocates from the heap through a counting_arena, so
+      //memory_usage() can tell what each kind of vector holds
+      typedef std::vector<vertex*, arena_allocator<vertex*, counting_arena<heap_arena>>> vertex_storage;
+      typedef std::vector<edge*, arena_allocator<edge*, counting_arena<heap_arena>>> edge_storage;
+      typedef std::vector<edge*, arena_allocator<edge*, counting_arena<heap_arena>>> adj_edge_storage;
+      typedef std::vector<size_t, arena_allocator<size_t, counting_arena<heap_arena>>> index_storage;
       //vertex container should contain "vertex*" or shared_ptr<vertex>
       typedef typename vertex_storage::iterator vertex_iterator; //vertex iterators
       typedef typename vertex_storage::const_iterator const_vertex_iterator;
@@ -41,7 +73,14 @@ template<typename VertexProperty, typename EdgeProperty>
       typedef typename adj_edge_storage::const_iterator const_adj_edge_iterator;
 
       ///required constructor/destructors
-      graph_vector() : m_max_vd(0) { }
+      graph_vector() : m_vertex_arena(&m_arena), m_edge_arena(&m_arena),
+        m_adjacency_arena(&m_arena), m_max_vd(0),
+        m_vertices(counted<vertex*>(m_vertex_arena)),
+        m_edges(counted<edge*>(m_edge_arena)),
+        m_vertex_ids(counted<size_t>(m_vertex_arena)),
+        m_vertex_slot(counted<size_t>(m_vertex_arena)),
+        m_edge_sources(counted<size_t>(m_edge_arena)),
+        m_edge_targets(counted<size_t>(m_edge_arena)) { }
 
       ~graph_vector() {
         clear();
@@ -68,41 +107,33 @@ template<typename VertexProperty, typename EdgeProperty>
       size_t num_edges() const {return m_edges.size();}
 
       vertex_iterator find_vertex(vertex_descriptor vd) {
-        return std::find_if(m_vertices.begin(), m_vertices.end(),
-            [&](const vertex* const v) {
-            return v->descriptor() == vd;
-            });
+        return m_vertices.begin() + vertex_position(vd);
       }
 
       const_vertex_iterator find_vertex(vertex_descriptor vd) const {
-        return std::find_if(m_vertices.cbegin(), m_vertices.cend(),
-            [&](const vertex* const v) {
-            return v->descriptor() == vd;
-            });
+        return m_vertices.cbegin() + vertex_position(vd);
       }
 
       edge_iterator find_edge(edge_descriptor ed) {
-        return std::find_if(m_edges.begin(), m_edges.end(),
-            [&](const edge* const e) {
-            return e->descriptor() == ed;
-            });
+        return m_edges.begin() + edge_position(ed);
       }
 
       const_edge_iterator find_edge(edge_descriptor ed) const {
-        return std::find_if(m_edges.cbegin(), m_edges.cend(),
-            [&](const edge* e) {
-            return e->descriptor() == ed;
-            });
+        return m_edges.cbegin() + edge_position(ed);
       }
 
       //@todo modifiers
       vertex_descriptor insert_vertex(const VertexProperty& vp) {
 
         //construct vertex obj and assign it to var of appr type
-      auto ins_vert = new vertex(m_max_vd, vp);
+      auto ins_vert = new vertex(m_max_vd, vp, counted<edge*>(m_adjacency_arena));
     
       //insert that into the vector that contains all vertices 
+      if (sorted)
+        set_vertex_slot(m_max_vd, m_vertices.size());
       m_vertices.push_back(ins_vert);
+      if (soa)
+        m_vertex_ids.push_back(m_max_vd);
     
       //add the incrementation to the return value to insure the next insertion gets its unique 
       //vertex descriptor...
@@ -116,7 +147,12 @@ template<typename VertexProperty, typename EdgeProperty>
       auto ins_edg = new edge(sd, td, ep);
 
       //insert the given obj into the vector that contains all edges
+      ins_edg->m_slot = m_edges.size();
       m_edges.push_back(ins_edg);
+      if (soa) {
+        m_edge_sources.push_back(sd);
+        m_edge_targets.push_back(td);
+      }
     
       //use find_vertex() so find vertex with given descriptor and assign it to
       //var of appropriate type. Important since this represents the vertex that is one side of the edge 
@@ -126,7 +162,11 @@ template<typename VertexProperty, typename EdgeProperty>
       //Now, since we have source vertex we dereference the vertex of interest 
       //and insert the given edge into that particular vertex's outgoing edge container. 
       //In this case, its an outgoing edge since the vertex of interest is assummed to be a source vertex.
-      (*src_v)->m_out_edges.push_back(ins_edg);
+      //(vector_sorted keeps the list ordered by target)
+      if (sorted)
+        insert_sorted((*src_v)->m_out_edges, ins_edg, by_target());
+      else
+        (*src_v)->m_out_edges.push_back(ins_edg);
     
       //Now, we essentially do the same thing but for the target destination vertex
       //since, inserting an edge is going to be connected with 2 vertices 
@@ -139,7 +179,11 @@ template<typename VertexProperty, typename EdgeProperty>
       //Now, since we have target vertex we dereference the vertex of interest 
       //and insert the given edge into that particular vertex's incoming edge container. 
       //In this case, its an incoming edge since the vertex of interest is assummed to be a target vertex.
-      (*targ_v)->m_in_edges.push_back(ins_edg);
+      //(vector_sorted keeps the list ordered by source)
+      if (sorted)
+        insert_sorted((*targ_v)->m_in_edges, ins_edg, by_source());
+      else
+        (*targ_v)->m_in_edges.push_back(ins_edg);
 
 
 		return {sd,td};
@@ -160,32 +204,208 @@ template<typename VertexProperty, typename EdgeProperty>
         
       }
 
+      //insert a range of VertexProperty values; the new vertices get
+      //consecutive descriptors and the first one is returned
+      template<typename InputIterator>
+      vertex_descriptor insert_vertices(InputIterator first, InputIterator last) {
+        vertex_descriptor start = m_max_vd;
+        for(; first != last; ++first) {
+          if(soa)
+            m_vertex_ids.push_back(m_max_vd);
+          if(sorted)
+            set_vertex_slot(m_max_vd, m_vertices.size());
+          m_vertices.push_back(new vertex(m_max_vd, *first,
+                counted<edge*>(m_adjacency_arena)));
+          ++m_max_vd;
+        }
+        return start;
+      }
+
+      //insert a range of edge_value. The batch is sorted once, repeated
+      //descriptors keep their first occurrence, and edges already in the graph
+      //or with a missing endpoint are skipped. Only what the batch touches is
+      //looked at: its distinct endpoints are resolved once (through the slot
+      //index under vector_sorted, otherwise in one pass over the vertices),
+      //and each source's run of the batch is checked for duplicates against
+      //the targets of that source's out-list. Returns the number of edges
+      //inserted.
+      template<typename InputIterator>
+      size_t insert_edges(InputIterator first, InputIterator last) {
+        std::vector<edge_value> batch(first, last);
+        auto by_descriptor = [](const edge_value& a, const edge_value& b) {
+          return a.first < b.first;
+        };
+        std::stable_sort(batch.begin(), batch.end(), by_descriptor);
+
+        //the batch's distinct endpoints and their vertices
+        std::vector<vertex_descriptor> ends;
+        ends.reserve(2 * batch.size());
+        for(auto& ev : batch) {
+          ends.push_back(ev.first.first);
+          ends.push_back(ev.first.second);
+        }
+        std::sort(ends.begin(), ends.end());
+        ends.erase(std::unique(ends.begin(), ends.end()), ends.end());
+        std::vector<vertex*> ends_v(ends.size(), nullptr);
+        if(sorted) {
+          for(size_t i = 0; i < ends.size(); ++i) {
+            size_t pos = vertex_position(ends[i]);
+            if(pos != m_vertices.size())
+              ends_v[i] = m_vertices[pos];
+          }
+        }
+        else {
+          size_t found = 0;
+          for(auto vi = m_vertices.begin(); vi != m_vertices.end() && found != ends.size(); ++vi) {
+            auto i = std::lower_bound(ends.begin(), ends.end(), (*vi)->descriptor());
+            if(i != ends.end() && *i == (*vi)->descriptor()) {
+              ends_v[i - ends.begin()] = *vi;
+              ++found;
+            }
+          }
+        }
+        auto end_index = [&](vertex_descriptor vd) {
+          return size_t(std::lower_bound(ends.begin(), ends.end(), vd) - ends.begin());
+        };
+
+        //vector_sorted: the batch arrives in (source, target) order, so the
+        //entries appended to each touched list are sorted among themselves and
+        //only need merging with what the list held before
+        std::vector<size_t> old_out, old_in;
+        if(sorted) {
+          old_out.resize(ends.size());
+          old_in.resize(ends.size());
+          for(size_t i = 0; i < ends.size(); ++i)
+            if(ends_v[i]) {
+              old_out[i] = ends_v[i]->m_out_edges.size();
+              old_in[i] = ends_v[i]->m_in_edges.size();
+            }
+        }
+
+        m_edges.reserve(m_edges.size() + batch.size());
+        if(soa) {
+          m_edge_sources.reserve(m_edges.capacity());
+          m_edge_targets.reserve(m_edges.capacity());
+        }
+        size_t inserted = 0;
+        std::vector<vertex_descriptor> existing; //targets of the current source
+        for(size_t i = 0, j; i < batch.size(); i = j) {
+          vertex_descriptor sd = batch[i].first.first;
+          for(j = i; j < batch.size() && batch[j].first.first == sd; ++j) {}
+          vertex* src = ends_v[end_index(sd)];
+          if(!src)
+            continue;
+          existing.clear();
+          for(auto e : src->m_out_edges)
+            existing.push_back(e->target());
+          if(!sorted)
+            std::sort(existing.begin(), existing.end());
+          auto ex = existing.cbegin();
+          for(size_t k = i; k < j; ++k) {
+            const edge_descriptor& ed = batch[k].first;
+            if(k > i && batch[k - 1].first == ed)
+              continue;
+            ex = std::lower_bound(ex, existing.cend(), ed.second);
+            vertex* targ = ends_v[end_index(ed.second)];
+            if(!targ || (ex != existing.cend() && *ex == ed.second))
+              continue;
+            auto ins_edg = new edge(ed.first, ed.second, batch[k].second);
+            ins_edg->m_slot = m_edges.size();
+            m_edges.push_back(ins_edg);
+            if(soa) {
+              m_edge_sources.push_back(ed.first);
+              m_edge_targets.push_back(ed.second);
+            }
+            src->m_out_edges.push_back(ins_edg);
+            targ->m_in_edges.push_back(ins_edg);
+            ++inserted;
+          }
+        }
+        if(sorted)
+          for(size_t i = 0; i < ends.size(); ++i)
+            if(ends_v[i]) {
+              auto& out = ends_v[i]->m_out_edges;
+              auto& in = ends_v[i]->m_in_edges;
+              std::inplace_merge(out.begin(), out.begin() + old_out[i], out.end(), by_target());
+              std::inplace_merge(in.begin(), in.begin() + old_in[i], in.end(), by_source());
+            }
+        return inserted;
+      }
+
       void erase_vertex(vertex_descriptor vd) {
 
         //find_vertex() to find the vertex passed by function and assign it to a variable with a necessary type
     auto erase_v = find_vertex(vd);
 
     //we check if the passed vertex was accurately found from our previous line of code..
-    if (erase_v != vertices_end()) {
-
-  //loop over each outgoin edge in container associated with the 
-       //vertex that was passed to the function and
-       //assign it var of appropriate type so we 
-       //can perform necessary erase function on it. It will erase each of 
-       // the vertex's 
-       //associated outgoing edges and erase the outgoing edge from outgoing edge container
-       //and erase incoming edge from incoming edge container
-    for (auto erase_out_edg : (*erase_v)->m_out_edges) {
-        erase_edge(erase_out_edg->descriptor());
-    }
+    if (erase_v != vertices_end() && sorted) {
+
+      //every incident edge is unlinked from the opposite endpoint's sorted
+      //list and swapped out of the edge vector, so the cost is proportional
+      //to the degrees involved. Self-loops are left to the outgoing pass.
+      vertex* v = *erase_v;
+      for (auto erase_in_edg : v->m_in_edges) {
+        if (erase_in_edg->source() == vd)
+          continue;
+        erase_sorted(vertex_at(erase_in_edg->source())->m_out_edges, erase_in_edg, by_target());
+        swap_pop_edge(erase_in_edg);
+      }
+      for (auto erase_out_edg : v->m_out_edges) {
+        if (erase_out_edg->target() != vd)
+          erase_sorted(vertex_at(erase_out_edg->target())->m_in_edges, erase_out_edg, by_source());
+        swap_pop_edge(erase_out_edg);
+      }
 
-     
-    delete *erase_v;  
+      //move the last vertex into the hole
+      size_t slot = m_vertex_slot[vd];
+      m_vertices[slot] = m_vertices.back();
+      m_vertex_slot[m_vertices[slot]->descriptor()] = slot;
+      m_vertices.pop_back();
+      m_vertex_slot[vd] = npos;
+      delete v;
+    }
+    else if (erase_v != vertices_end()) {
+
+      //collect every incident edge, outgoing and incoming (a self-loop is in
+      //both lists, so it is taken from the outgoing one only), and unlink them
+      //all in one pass over the graph instead of one erase_edge() each
+      std::vector<edge*> erase_edgs((*erase_v)->m_out_edges.begin(),
+          (*erase_v)->m_out_edges.end());
+      for (auto erase_in_edg : (*erase_v)->m_in_edges)
+        if (erase_in_edg->source() != vd)
+          erase_edgs.push_back(erase_in_edg);
+      unlink_edges(erase_edgs);
+
+      delete *erase_v;
+
+      //erase vertex from vector that contains all the vertices....
+      if (soa)
+        m_vertex_ids.erase(m_vertex_ids.begin() + (erase_v - m_vertices.begin()));
+      m_vertices.erase(erase_v);
+    }
+      }
 
-    //erase vertex from vector that contains all the vertices....
-    m_vertices.erase(erase_v);  
-}
-       
+      //erase every edge of a range of edge_descriptor; descriptors not in the
+      //graph are ignored. The batch is matched against the edge list in one
+      //pass and unlinked in one more, instead of a linear find and vector
+      //erase per edge. Returns the number of edges erased.
+      template<typename InputIterator>
+      size_t erase_edges(InputIterator first, InputIterator last) {
+        if(sorted) {
+          //each erase is already a binary search and a swap-and-pop
+          size_t before = m_edges.size();
+          for(; first != last; ++first)
+            erase_edge(*first);
+          return before - m_edges.size();
+        }
+        std::vector<edge_descriptor> eds(first, last);
+        std::sort(eds.begin(), eds.end());
+        std::vector<edge*> erase_edgs;
+        for (auto e : m_edges)
+          if (std::binary_search(eds.begin(), eds.end(), e->descriptor()))
+            erase_edgs.push_back(e);
+        unlink_edges(erase_edgs);
+        return erase_edgs.size();
       }
 
       void erase_edge(edge_descriptor ed) {
@@ -194,7 +414,13 @@ template<typename VertexProperty, typename EdgeProperty>
        auto erase_edg = find_edge(ed);
 
      //we check if the passed edge was accurately found from our previous line of code..
-    if (erase_edg != edges_end()) {
+    if (erase_edg != edges_end() && sorted) {
+      edge* e = *erase_edg;
+      erase_sorted(vertex_at(ed.first)->m_out_edges, e, by_target());
+      erase_sorted(vertex_at(ed.second)->m_in_edges, e, by_source());
+      swap_pop_edge(e);
+    }
+    else if (erase_edg != edges_end()) {
 
       //we remember that every time we inserted an edge we created a pair between the source and target vertices
       //associated with that particular inserted edge as from insert_edge()... 
@@ -227,6 +453,11 @@ template<typename VertexProperty, typename EdgeProperty>
     delete *erase_edg; 
 
     //erase the edge from the vector that contains all edges 
+    if (soa) {
+      size_t i = erase_edg - m_edges.begin();
+      m_edge_sources.erase(m_edge_sources.begin() + i);
+      m_edge_targets.erase(m_edge_targets.begin() + i);
+    }
     m_edges.erase(erase_edg);  
 }
 
@@ -242,27 +473,168 @@ template<typename VertexProperty, typename EdgeProperty>
         for(auto e : m_edges)
           delete e;
         m_edges.clear();
+        m_vertex_ids.clear();
+        m_vertex_slot.clear();
+        m_edge_sources.clear();
+        m_edge_targets.clear();
+      }
+
+      //bytes held by the graph, by what they store; container bytes are
+      //counted by the counting_arena behind every vector, including the
+      //adjacency lists and the arrays of vector_soa and vector_sorted
+      graph_memory_usage memory_usage() const {
+        graph_memory_usage u;
+        u.vertex_index = m_vertex_arena.bytes();
+        u.edge_index = m_edge_arena.bytes();
+        u.adjacency = m_adjacency_arena.bytes();
+        u.vertex_objects = m_vertices.size() * sizeof(vertex);
+        u.edge_objects = m_edges.size() * sizeof(edge);
+        return u;
       }
 
-      template<typename V, typename E>
-        friend std::istream& operator>>(std::istream& is, graph<V, E>& g);
+      template<typename V, typename E, typename L>
+        friend std::istream& operator>>(std::istream& is, graph_vector<V, E, L>& g);
 
-      template<typename V, typename E>
-        friend std::ostream& operator<<(std::ostream& os, const graph<V, E>& g);
+      template<typename V, typename E, typename L>
+        friend std::ostream& operator<<(std::ostream& os, const graph_vector<V, E, L>& g);
 
     private:
 
+      static const bool soa = std::is_same<Policy, vector_soa>::value;
+      static const bool sorted = std::is_same<Policy, vector_sorted>::value;
+      enum : size_t {npos = size_t(-1)};
+
+      //allocator drawing from the heap through the counting arena a
+      template<typename T>
+      static arena_allocator<T, counting_arena<heap_arena>> counted(counting_arena<heap_arena>& a) {
+        return arena_allocator<T, counting_arena<heap_arena>>(&a);
+      }
+
+      //adjacency orders of vector_sorted
+      struct by_target {
+        bool operator()(const edge* e, const edge* f) const {return e->target() < f->target();}
+        bool operator()(const edge* e, vertex_descriptor t) const {return e->target() < t;}
+      };
+      struct by_source {
+        bool operator()(const edge* e, const edge* f) const {return e->source() < f->source();}
+        bool operator()(const edge* e, vertex_descriptor s) const {return e->source() < s;}
+      };
+
+      //vector_sorted: record that vertex vd is at m_vertices[slot]
+      void set_vertex_slot(vertex_descriptor vd, size_t slot) {
+        if (vd >= m_vertex_slot.size())
+          m_vertex_slot.resize(vd + 1, npos);
+        m_vertex_slot[vd] = slot;
+      }
+
+      //vector_sorted: the vertex with descriptor vd, which must exist
+      vertex* vertex_at(vertex_descriptor vd) const {
+        return m_vertices[m_vertex_slot[vd]];
+      }
+
+      //vector_sorted: insert e after any equal entries of the sorted list c
+      template<typename Order>
+      static void insert_sorted(adj_edge_storage& c, edge* e, Order order) {
+        c.insert(std::upper_bound(c.begin(), c.end(), e, order), e);
+      }
+
+      //vector_sorted: remove e from the sorted list c
+      template<typename Order>
+      static void erase_sorted(adj_edge_storage& c, edge* e, Order order) {
+        auto i = std::find(std::lower_bound(c.begin(), c.end(), e, order), c.end(), e);
+        assert(i != c.end());
+        c.erase(i);
+      }
+
+      //vector_sorted: move the last edge into e's slot and delete e
+      void swap_pop_edge(edge* e) {
+        m_edges[e->m_slot] = m_edges.back();
+        m_edges[e->m_slot]->m_slot = e->m_slot;
+        m_edges.pop_back();
+        delete e;
+      }
+
+      //position of the vertex with descriptor vd in m_vertices, or its size
+      size_t vertex_position(vertex_descriptor vd) const {
+        if (sorted)
+          return vd < m_vertex_slot.size() && m_vertex_slot[vd] != npos ?
+            m_vertex_slot[vd] : m_vertices.size();
+        if (soa)
+          return simd_find(m_vertex_ids.data(), m_vertex_ids.size(), vd);
+        return std::find_if(m_vertices.cbegin(), m_vertices.cend(),
+            [&](const vertex* const v) {
+            return v->descriptor() == vd;
+            }) - m_vertices.cbegin();
+      }
+
+      //position of the edge with descriptor ed in m_edges, or its size
+      size_t edge_position(edge_descriptor ed) const {
+        if (sorted) {
+          if (ed.first >= m_vertex_slot.size() || m_vertex_slot[ed.first] == npos)
+            return m_edges.size();
+          const adj_edge_storage& out = vertex_at(ed.first)->m_out_edges;
+          auto i = std::lower_bound(out.begin(), out.end(), ed.second, by_target());
+          return i != out.end() && (*i)->target() == ed.second ?
+            (*i)->m_slot : m_edges.size();
+        }
+        if (soa)
+          return simd_find_pair(m_edge_sources.data(), m_edge_targets.data(),
+              m_edge_sources.size(), ed.first, ed.second);
+        return std::find_if(m_edges.cbegin(), m_edges.cend(),
+            [&](const edge* e) {
+            return e->descriptor() == ed;
+            }) - m_edges.cbegin();
+      }
+
+      //remove the given edges from the edge list and from every adjacency
+      //list, then delete them; O(V + E) for the whole batch
+      void unlink_edges(std::vector<edge*>& erase_edgs) {
+        if (erase_edgs.empty())
+          return;
+        std::sort(erase_edgs.begin(), erase_edgs.end());
+        auto doomed = [&](edge* e) {
+          return std::binary_search(erase_edgs.begin(), erase_edgs.end(), e);
+        };
+        auto unlink = [&](edge_storage& c) {
+          c.erase(std::remove_if(c.begin(), c.end(), doomed), c.end());
+        };
+        unlink(m_edges);
+        if (soa) {
+          m_edge_sources.clear();
+          m_edge_targets.clear();
+          for (auto e : m_edges) {
+            m_edge_sources.push_back(e->source());
+            m_edge_targets.push_back(e->target());
+          }
+        }
+        for (auto v : m_vertices) {
+          unlink(v->m_out_edges);
+          unlink(v->m_in_edges);
+        }
+        for (auto e : erase_edgs)
+          delete e;
+      }
+
+      heap_arena m_arena; // Global heap, for the allocators of the vectors
+      counting_arena<heap_arena> m_vertex_arena;     // Counts m_vertices, m_vertex_ids, m_vertex_slot
+      counting_arena<heap_arena> m_edge_arena;       // Counts m_edges, m_edge_sources, m_edge_targets
+      counting_arena<heap_arena> m_adjacency_arena;  // Counts every adjacency list
       size_t m_max_vd; // Id generator for next vertex to be inserted
       vertex_storage m_vertices;  // List of all vertices in the graph
       edge_storage m_edges;    // List of  all edges in the graph
+      index_storage m_vertex_ids;    // vector_soa: descriptor of each of m_vertices
+      index_storage m_vertex_slot;   // vector_sorted: index in m_vertices by descriptor
+      index_storage m_edge_sources;  // vector_soa: source of each of m_edges
+      index_storage m_edge_targets;  // vector_soa: target of each of m_edges
 
       ///required internal classes
 
       class vertex {
         public:
           ///required constructors/destructors
-          vertex(vertex_descriptor vd, const VertexProperty& v) :
-            m_descriptor(vd), m_property(v) { }
+          vertex(vertex_descriptor vd, const VertexProperty& v,
+              const arena_allocator<edge*, counting_arena<heap_arena>>& a) :
+            m_descriptor(vd), m_property(v), m_out_edges(a), m_in_edges(a) { }
 
           ///required vertex operations
 
@@ -272,7 +644,15 @@ template<typename VertexProperty, typename EdgeProperty>
           adj_edge_iterator end() {return m_out_edges.end();}
           const_adj_edge_iterator cend() const {return m_out_edges.cend();}
 
+          //incoming edge iterators
+          adj_edge_iterator in_begin() {return m_in_edges.begin();}
+          const_adj_edge_iterator in_cbegin() const {return m_in_edges.cbegin();}
+          adj_edge_iterator in_end() {return m_in_edges.end();}
+          const_adj_edge_iterator in_cend() const {return m_in_edges.cend();}
+
           //accessors
+          size_t out_degree() const {return m_out_edges.size();}
+          size_t in_degree() const {return m_in_edges.size();}
           const vertex_descriptor descriptor() const {return m_descriptor;}
           VertexProperty& property() {return m_property;}
           const VertexProperty& property() const {return m_property;}
@@ -290,7 +670,8 @@ template<typename VertexProperty, typename EdgeProperty>
         public:
           ///required constructors/destructors
           edge(vertex_descriptor s, vertex_descriptor t,
-              const EdgeProperty& w) : m_source(s), m_target(t), m_property(w) { }
+              const EdgeProperty& w) : m_source(s), m_target(t), m_property(w),
+              m_slot(0) { }
 
           ///required edge operations
 
@@ -305,32 +686,31 @@ template<typename VertexProperty, typename EdgeProperty>
           vertex_descriptor m_source; // Descriptor of source vertex
           vertex_descriptor m_target;  // Descriptor of target vertex
           EdgeProperty m_property;    // Label or weight on the edge
+          size_t m_slot;              // Index in m_edges (kept by vector_sorted)
+
+          friend class graph_vector;
       };
 
   };
 
-template<typename V, typename E>
-  std::istream& operator>>(std::istream& is, graph_vector<V, E>& g) {
+template<typename V, typename E, typename L>
+  std::istream& operator>>(std::istream& is, graph_vector<V, E, L>& g) {
     size_t num_verts, num_edges;
     is >> num_verts >> num_edges;
-    g.m_vertices.reserve(num_verts);
-    g.m_vertices.reserve(num_edges);
-    for(size_t i = 0; i < num_verts; ++i) {
-      V v;
+    std::vector<V> verts(num_verts);
+    for(auto& v : verts)
       is >> v;
-      g.insert_vertex(v);
-    }
-    for(size_t i = 0; i < num_edges; ++i) {
-      typename graph<V, E>::vertex_descriptor s, t;
-      E e;
-      is >> s >> t >> e;
-      g.insert_edge(s, t, e);
-    }
+    g.m_vertices.reserve(g.m_vertices.size() + num_verts);
+    g.insert_vertices(verts.begin(), verts.end());
+    std::vector<typename graph_vector<V, E, L>::edge_value> edges(num_edges);
+    for(auto& ev : edges)
+      is >> ev.first.first >> ev.first.second >> ev.second;
+    g.insert_edges(edges.begin(), edges.end());
     return is;
   }
 
-template<typename V, typename E>
-  std::ostream& operator<<(std::ostream& os, const graph_vector<V, E>& g) {
+template<typename V, typename E, typename L>
+  std::ostream& operator<<(std::ostream& os, const graph_vector<V, E, L>& g) {
     os << g.num_vertices() << " " << g.num_edges() << std::endl;
     for(auto i = g.vertices_cbegin(); i != g.vertices_cend(); ++i)
       os << (*i)->property() << std::endl;
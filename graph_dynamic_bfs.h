@@ -0,0 +1,269 @@
+#ifndef _GRAPH_DYNAMIC_BFS_H_
+#define _GRAPH_DYNAMIC_BFS_H_
+
+#include <functional>
+#include <queue>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "graph_algorithms.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Breadth-first distances and parents from one root, kept up to date while
+/// the graph changes, so the cost of an update is proportional to the part
+/// of the BFS tree it affects rather than to the whole graph.
+///
+/// Changes either go through the insert/erase members, which apply them to
+/// the graph and repair the tree, or are applied to the graph directly and
+/// then reported with edge_inserted(), edge_erased() and vertex_inserted().
+///
+/// An inserted edge s->t that shortens the path to t lowers t and propagates
+/// the decrease breadth-first, only past the vertices that get closer. An
+/// erased tree edge is repaired as by Ramalingam and Reps: first the
+/// affected vertices are collected level by level down the subtree of t,
+/// stopping at every vertex that still has an unaffected in-neighbour one
+/// level up (which becomes its parent), then only the affected vertices get
+/// new distances, from their unaffected in-neighbours, in order of
+/// distance. Erasing an edge that is not in the tree changes nothing.
+///
+/// Between updates dist[vd] is the number of edges on a shortest path from
+/// the root to vd and parent[vd] the previous vertex on one; as with
+/// multi_source_bfs both are size_t(-1) for unreachable vertices and
+/// descriptors without a vertex, and the parent of the root is -1. Vertex
+/// objects must keep their address while in the graph, as they do in graph
+/// and graph_vector.
+////////////////////////////////////////////////////////////////////////////////
+template<typename Graph>
+class dynamic_bfs {
+
+    typedef typename std::decay<decltype(*std::declval<const Graph&>().vertices_cbegin())>::type
+      vertex_ptr;
+
+  public:
+
+    typedef typename Graph::vertex_descriptor vertex_descriptor;
+    typedef typename Graph::edge_descriptor edge_descriptor;
+
+    ///@brief Track the BFS tree of g rooted at root, which must be a vertex
+    ///       of g.
+    dynamic_bfs(Graph& g, vertex_descriptor root) : m_graph(g), m_root(root) {
+      recompute();
+    }
+
+    ///@brief Accessors
+    vertex_descriptor root() const {return m_root;}
+    const std::vector<size_t>& distances() const {return m_dist;}
+    const std::vector<vertex_descriptor>& parents() const {return m_parent;}
+    size_t distance(vertex_descriptor vd) const {
+      return vd < m_dist.size() ? m_dist[vd] : size_t(-1);
+    }
+    vertex_descriptor parent(vertex_descriptor vd) const {
+      return vd < m_parent.size() ? m_parent[vd] : vertex_descriptor(-1);
+    }
+
+    ///@brief Number of vertices whose distance or parent the last update
+    ///       looked at, i.e. the size of the region it repaired.
+    size_t last_update_size() const {return m_touched;}
+
+    ///@brief Rebuild the tree from scratch, with a breadth-first search
+    ///       from the root.
+    void recompute() {
+      index_vertices(static_cast<const Graph&>(m_graph), m_vertices);
+      m_dist.assign(m_vertices.size(), size_t(-1));
+      m_parent.assign(m_vertices.size(), vertex_descriptor(-1));
+      m_affected.assign(m_vertices.size(), false);
+      m_touched = 0;
+      if(m_root >= m_vertices.size() || !m_vertices[m_root])
+        return;
+      m_dist[m_root] = 0;
+      lower(m_root);
+    }
+
+    ///@brief Modifiers, applied to the graph and then repaired
+    template<typename VertexProperty>
+    vertex_descriptor insert_vertex(const VertexProperty& vp) {
+      vertex_descriptor vd = m_graph.insert_vertex(vp);
+      vertex_inserted(vd);
+      return vd;
+    }
+
+    template<typename EdgeProperty>
+    void insert_edge(vertex_descriptor sd, vertex_descriptor td, const EdgeProperty& ep) {
+      m_graph.insert_edge(sd, td, ep);
+      edge_inserted(sd, td);
+    }
+
+    void erase_edge(edge_descriptor ed) {
+      m_graph.erase_edge(ed);
+      edge_erased(ed.first, ed.second);
+    }
+
+    ///@brief Erase vertex vd. Its in-edges are erased one by one first, so
+    ///       the vertices reached through it are repaired before it goes;
+    ///       its out-edges are then no longer tree edges. Erasing the root
+    ///       leaves every vertex unreachable.
+    void erase_vertex(vertex_descriptor vd) {
+      if(vd >= m_vertices.size() || !m_vertices[vd])
+        return;
+      if(vd == m_root) {
+        m_graph.erase_vertex(vd);
+        m_vertices[vd] = nullptr;
+        m_touched = m_dist.size();
+        m_dist.assign(m_dist.size(), size_t(-1));
+        m_parent.assign(m_parent.size(), vertex_descriptor(-1));
+        return;
+      }
+      std::vector<vertex_descriptor> sources;
+      for(auto ai = m_vertices[vd]->in_cbegin(); ai != m_vertices[vd]->in_cend(); ++ai)
+        if((*ai)->source() != vd)
+          sources.push_back((*ai)->source());
+      size_t touched = 0;
+      for(auto s : sources) {
+        erase_edge(edge_descriptor(s, vd));
+        touched += m_touched;
+      }
+      m_graph.erase_vertex(vd);
+      m_vertices[vd] = nullptr;
+      m_touched = touched;
+    }
+
+    ///@brief Notifications of changes already made to the graph
+    void vertex_inserted(vertex_descriptor vd) {
+      grow(vd);
+      m_vertices[vd] = *static_cast<const Graph&>(m_graph).find_vertex(vd);
+      m_touched = 0;
+    }
+
+    void edge_inserted(vertex_descriptor sd, vertex_descriptor td) {
+      m_touched = 0;
+      if(sd >= m_dist.size() || td >= m_dist.size() || m_dist[sd] == size_t(-1) ||
+          m_dist[sd] + 1 >= m_dist[td])
+        return;
+      m_dist[td] = m_dist[sd] + 1;
+      m_parent[td] = sd;
+      lower(td);
+    }
+
+    void edge_erased(vertex_descriptor sd, vertex_descriptor td) {
+      m_touched = 0;
+      if(td >= m_parent.size() || m_parent[td] != sd || td == m_root)
+        return;
+
+      //phase 1: the affected vertices, whose every shortest path used the
+      //edge. The queue holds them in order of distance, so when a child is
+      //looked at every vertex one level up is already known to be affected
+      //or not.
+      std::vector<vertex_descriptor> affected;
+      m_touched = 1;
+      if(adopt(td))
+        return;
+      m_affected[td] = true;
+      affected.push_back(td);
+      for(size_t head = 0; head < affected.size(); ++head) {
+        vertex_descriptor u = affected[head];
+        for(auto ai = m_vertices[u]->cbegin(); ai != m_vertices[u]->cend(); ++ai) {
+          vertex_descriptor t = (*ai)->target();
+          if(t >= m_parent.size() || m_parent[t] != u || m_affected[t])
+            continue;
+          ++m_touched;
+          if(!adopt(t)) {
+            m_affected[t] = true;
+            affected.push_back(t);
+          }
+        }
+      }
+
+      //phase 2: new distances for the affected vertices only, seeded from
+      //their unaffected in-neighbours and settled in order of distance
+      typedef std::pair<size_t, vertex_descriptor> entry;
+      std::priority_queue<entry, std::vector<entry>, std::greater<entry>> q;
+      for(auto a : affected) {
+        m_dist[a] = size_t(-1);
+        m_parent[a] = vertex_descriptor(-1);
+      }
+      for(auto a : affected)
+        for(auto ai = m_vertices[a]->in_cbegin(); ai != m_vertices[a]->in_cend(); ++ai) {
+          vertex_descriptor s = (*ai)->source();
+          if(s < m_dist.size() && !m_affected[s] && m_dist[s] != size_t(-1) &&
+              m_dist[s] + 1 < m_dist[a]) {
+            m_dist[a] = m_dist[s] + 1;
+            m_parent[a] = s;
+          }
+        }
+      for(auto a : affected)
+        if(m_dist[a] != size_t(-1))
+          q.push(entry(m_dist[a], a));
+      while(!q.empty()) {
+        entry top = q.top();
+        q.pop();
+        vertex_descriptor u = top.second;
+        if(top.first != m_dist[u])
+          continue;
+        for(auto ai = m_vertices[u]->cbegin(); ai != m_vertices[u]->cend(); ++ai) {
+          vertex_descriptor t = (*ai)->target();
+          if(t < m_dist.size() && m_affected[t] && m_dist[u] + 1 < m_dist[t]) {
+            m_dist[t] = m_dist[u] + 1;
+            m_parent[t] = u;
+            q.push(entry(m_dist[t], t));
+          }
+        }
+      }
+      for(auto a : affected)
+        m_affected[a] = false;
+    }
+
+  private:
+    ///@brief Make room for descriptor vd
+    void grow(vertex_descriptor vd) {
+      if(vd < m_vertices.size())
+        return;
+      m_vertices.resize(vd + 1, nullptr);
+      m_dist.resize(vd + 1, size_t(-1));
+      m_parent.resize(vd + 1, vertex_descriptor(-1));
+      m_affected.resize(vd + 1, false);
+    }
+
+    ///@brief Propagate the lowered distance of start breadth-first, through
+    ///       the vertices it brings closer to the root.
+    void lower(vertex_descriptor start) {
+      std::vector<vertex_descriptor> q(1, start);
+      for(size_t head = 0; head < q.size(); ++head) {
+        vertex_descriptor u = q[head];
+        ++m_touched;
+        for(auto ai = m_vertices[u]->cbegin(); ai != m_vertices[u]->cend(); ++ai) {
+          vertex_descriptor t = (*ai)->target();
+          if(t < m_dist.size() && m_vertices[t] && m_dist[u] + 1 < m_dist[t]) {
+            m_dist[t] = m_dist[u] + 1;
+            m_parent[t] = u;
+            q.push_back(t);
+          }
+        }
+      }
+    }
+
+    ///@brief Give vd a parent among its unaffected in-neighbours one level
+    ///       up, keeping its distance. Returns whether there was one.
+    bool adopt(vertex_descriptor vd) {
+      for(auto ai = m_vertices[vd]->in_cbegin(); ai != m_vertices[vd]->in_cend(); ++ai) {
+        vertex_descriptor s = (*ai)->source();
+        if(s < m_dist.size() && !m_affected[s] && m_dist[s] != size_t(-1) &&
+            m_dist[s] + 1 == m_dist[vd]) {
+          m_parent[vd] = s;
+          return true;
+        }
+      }
+      return false;
+    }
+
+    Graph& m_graph;
+    vertex_descriptor m_root;
+    std::vector<vertex_ptr> m_vertices;        // Vertex of each descriptor, or nullptr
+    std::vector<size_t> m_dist;                // Distance from the root, or -1 if unreachable
+    std::vector<vertex_descriptor> m_parent;   // Previous vertex on a shortest path, or -1
+    std::vector<bool> m_affected;              // Scratch of edge_erased(), all false between calls
+    size_t m_touched;                          // Size of the last update
+};
+
+#endif
@@ -0,0 +1,363 @@
+#ifndef _GRAPH_GENERATORS_H_
+#define _GRAPH_GENERATORS_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+#include "graph_thread_pool.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Synthetic graphs for the tests, the timing and the benchmark programs.
+///
+/// The *_edges() emitters append the edges of a graph on vertices 0..n-1 to a
+/// batch of edge_value, with weights uniform in [0, 1). The work is cut into
+/// chunks whose boundaries depend only on the parameters, and chunk c draws
+/// from stream c of a graph_rng seeded with seed, so a batch is the same for
+/// every seed whether it is emitted serially or on a thread_pool of any size.
+///
+/// The initialize_*() functions take an empty graph or graph_vector, add
+/// vertices with properties 0..n-1 (descriptors 0..n-1) and insert the edges
+/// as one batch. They seed their emitter with rand(), so srand() makes a graph
+/// reproducible.
+////////////////////////////////////////////////////////////////////////////////
+
+///@brief Work of one chunk of an emitter, in edges
+const size_t generator_grain = size_t(1) << 16;
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// xoshiro256** pseudo random generator, seeded through splitmix64. It is a
+/// UniformRandomBitGenerator, so it also works with <random> and
+/// std::shuffle.
+////////////////////////////////////////////////////////////////////////////////
+class graph_rng {
+
+  public:
+
+    typedef uint64_t result_type;
+
+    ///@brief Generator for stream `stream` of `seed`. Different streams of
+    ///       one seed are independent for all practical purposes.
+    explicit graph_rng(uint64_t seed = 0, uint64_t stream = 0) {
+      uint64_t x = seed;
+      x = splitmix64(x) ^ (stream * 0xd1b54a32d192ed03ull);
+      for(auto& s : m_state)
+        s = splitmix64(x);
+    }
+
+    static constexpr result_type min() {return 0;}
+    static constexpr result_type max() {return ~result_type(0);}
+
+    result_type operator()() {
+      const uint64_t result = rotl(m_state[1] * 5, 7) * 9;
+      const uint64_t t = m_state[1] << 17;
+      m_state[2] ^= m_state[0];
+      m_state[3] ^= m_state[1];
+      m_state[1] ^= m_state[2];
+      m_state[0] ^= m_state[3];
+      m_state[2] ^= t;
+      m_state[3] = rotl(m_state[3], 45);
+      return result;
+    }
+
+    ///@brief Uniform double in [0, 1)
+    double uniform() {return double((*this)() >> 11) * (1.0 / 9007199254740992.0);}
+
+    ///@brief Uniform integer in [0, n), n > 0, without modulo bias
+    ///       (Lemire's multiply-and-reject)
+    uint64_t below(uint64_t n) {
+      unsigned __int128 m = (unsigned __int128)(*this)() * n;
+      uint64_t low = uint64_t(m);
+      if(low < n) {
+        uint64_t threshold = -n % n;
+        while(low < threshold) {
+          m = (unsigned __int128)(*this)() * n;
+          low = uint64_t(m);
+        }
+      }
+      return uint64_t(m >> 64);
+    }
+
+    ///@brief Advance the splitmix64 state x and return its next output
+    static uint64_t splitmix64(uint64_t& x) {
+      uint64_t z = (x += 0x9e3779b97f4a7c15ull);
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+      return z ^ (z >> 31);
+    }
+
+  private:
+    static uint64_t rotl(uint64_t x, int k) {return (x << k) | (x >> (64 - k));}
+
+    uint64_t m_state[4];
+};
+
+
+///@brief Call f(c, rng, part) for every chunk c in [0, num_chunks), on pool
+///       when given, with rng drawing from stream c of seed and part an empty
+///       batch, then append the parts to out in chunk order.
+template<typename edge_value, typename F>
+void emit_edge_chunks(std::vector<edge_value>& out, size_t num_chunks, uint64_t seed,
+    thread_pool* pool, F f) {
+  std::vector<std::vector<edge_value>> parts(num_chunks);
+  auto emit = [&](size_t, size_t begin, size_t end) {
+    for(size_t c = begin; c < end; ++c) {
+      graph_rng rng(seed, c);
+      f(c, rng, parts[c]);
+    }
+  };
+  std::vector<size_t> offset(num_chunks + 1, out.size());
+  auto append = [&](size_t, size_t begin, size_t end) {
+    for(size_t c = begin; c < end; ++c) {
+      std::copy(parts[c].begin(), parts[c].end(), out.begin() + offset[c]);
+      std::vector<edge_value>().swap(parts[c]);
+    }
+  };
+
+  if(pool)
+    pool->parallel_for(num_chunks, 1, emit);
+  else
+    emit(0, 0, num_chunks);
+  for(size_t c = 0; c < num_chunks; ++c)
+    offset[c + 1] = offset[c] + parts[c].size();
+  out.resize(offset[num_chunks]);
+  if(pool)
+    pool->parallel_for(num_chunks, 1, append);
+  else
+    append(0, 0, num_chunks);
+}
+
+/// @brief append the edge s->t and t->s with weight w to a batch
+template<typename edge_value>
+void push_undirected(std::vector<edge_value>& batch, size_t s, size_t t, double w) {
+  batch.push_back(edge_value({s, t}, w));
+  batch.push_back(edge_value({t, s}, w));
+}
+
+
+///@brief Quadrant probabilities of R-MAT. The fourth one is 1 - a - b - c.
+///       The defaults are those of the Graph500 Kronecker generator.
+struct rmat_probabilities {
+  double a = 0.57;  // Both endpoints stay in the lower half
+  double b = 0.19;  // Target moves to the upper half
+  double c = 0.19;  // Source moves to the upper half
+};
+
+///@brief Append num_edges directed R-MAT edges on 2^scale vertices to out.
+///
+/// Each edge picks one quadrant of the adjacency matrix per bit of the
+/// endpoints, which gives the skewed, Kronecker-like degree distribution of
+/// real networks. The descriptors are then scrambled by a bijection of
+/// [0, 2^scale), so the hubs are spread over the descriptor space instead of
+/// all sitting next to 0. Duplicates and self-loops are kept: insert_edges()
+/// skips the duplicates.
+template<typename edge_value>
+void rmat_edges(std::vector<edge_value>& out, unsigned scale, size_t num_edges,
+    uint64_t seed, thread_pool* pool = nullptr,
+    rmat_probabilities p = rmat_probabilities()) {
+  const uint64_t mask = scale >= 64 ? ~uint64_t(0) : (uint64_t(1) << scale) - 1;
+  const uint64_t odd = (0x9e3779b97f4a7c15ull ^ seed) | 1;
+  auto scramble = [&](uint64_t v) {
+    v = (v * odd + seed) & mask;
+    v ^= v >> (scale / 2 + 1);
+    return (v * 0xbf58476d1ce4e5b9ull) & mask;
+  };
+  const double ab = p.a + p.b, abc = p.a + p.b + p.c;
+
+  size_t num_chunks = (num_edges + generator_grain - 1) / generator_grain;
+  emit_edge_chunks(out, num_chunks, seed, pool,
+      [&](size_t c, graph_rng& rng, std::vector<edge_value>& part) {
+    size_t count = std::min(generator_grain, num_edges - c * generator_grain);
+    part.reserve(count);
+    for(size_t i = 0; i < count; ++i) {
+      uint64_t s = 0, t = 0;
+      for(unsigned bit = 0; bit < scale; ++bit) {
+        double u = rng.uniform();
+        if(u >= abc) {
+          s |= uint64_t(1) << bit;
+          t |= uint64_t(1) << bit;
+        }
+        else if(u >= ab)
+          s |= uint64_t(1) << bit;
+        else if(u >= p.a)
+          t |= uint64_t(1) << bit;
+      }
+      part.push_back(edge_value({size_t(scramble(s)), size_t(scramble(t))}, rng.uniform()));
+    }
+  });
+}
+
+///@brief Append the directed Erdos-Renyi graph G(n, p) to out: every ordered
+///       pair of distinct vertices is an edge with probability p.
+///
+/// Rather than drawing n(n - 1) coins, the gap to the next edge is drawn from
+/// the geometric distribution (Batagelj and Brandes), so the cost is linear
+/// in the number of edges emitted.
+template<typename edge_value>
+void gnp_edges(std::vector<edge_value>& out, size_t n, double p, uint64_t seed,
+    thread_pool* pool = nullptr) {
+  if(n < 2 || p <= 0)
+    return;
+  const size_t row = n - 1;  // Candidate targets of one source
+  size_t rows_per_chunk = std::max<size_t>(1,
+      size_t(generator_grain / std::max(1.0, p * row)));
+  size_t num_chunks = (n + rows_per_chunk - 1) / rows_per_chunk;
+  const double log_q = std::log1p(-std::min(p, 1.0));
+
+  emit_edge_chunks(out, num_chunks, seed, pool,
+      [&](size_t c, graph_rng& rng, std::vector<edge_value>& part) {
+    size_t first = c * rows_per_chunk;
+    size_t last = std::min(n, first + rows_per_chunk);
+    size_t total = (last - first) * row;
+    part.reserve(size_t(p * total * 1.05) + 16);
+    for(size_t pos = 0; ; ++pos) {
+      //p == 1 makes log_q infinite and every skip 0
+      if(p < 1) {
+        double skip = std::floor(std::log1p(-rng.uniform()) / log_q);
+        if(skip >= double(total - pos))
+          break;
+        pos += size_t(skip);
+      }
+      if(pos >= total)
+        break;
+      size_t s = first + pos / row, t = pos % row;
+      if(t >= s)
+        ++t;
+      part.push_back(edge_value({s, t}, rng.uniform()));
+    }
+  });
+}
+
+///@brief Append a rootn x rootn undirected mesh to out: vertex i is joined
+///       to i + 1 within its row and to i + rootn, both ways with one weight.
+template<typename edge_value>
+void mesh_edges(std::vector<edge_value>& out, size_t rootn, uint64_t seed,
+    thread_pool* pool = nullptr) {
+  const size_t n = rootn * rootn;
+  size_t rows_per_chunk = std::max<size_t>(1, generator_grain / std::max<size_t>(1, 4 * rootn));
+  size_t num_chunks = (rootn + rows_per_chunk - 1) / rows_per_chunk;
+
+  emit_edge_chunks(out, num_chunks, seed, pool,
+      [&](size_t c, graph_rng& rng, std::vector<edge_value>& part) {
+    size_t first = c * rows_per_chunk * rootn;
+    size_t last = std::min(n, first + rows_per_chunk * rootn);
+    part.reserve(4 * (last - first));
+    for(size_t i = first; i < last; ++i) {
+      size_t x = i + 1;
+      size_t y = i + rootn;
+
+      if(x % rootn != 0)
+        push_undirected(part, i, x, rng.uniform());
+
+      if(y < n)
+        push_undirected(part, i, y, rng.uniform());
+    }
+  });
+}
+
+///@brief Append the complete directed graph on n vertices to out.
+template<typename edge_value>
+void complete_edges(std::vector<edge_value>& out, size_t n, uint64_t seed,
+    thread_pool* pool = nullptr) {
+  if(n < 2)
+    return;
+  size_t rows_per_chunk = std::max<size_t>(1, generator_grain / (n - 1));
+  size_t num_chunks = (n + rows_per_chunk - 1) / rows_per_chunk;
+
+  emit_edge_chunks(out, num_chunks, seed, pool,
+      [&](size_t c, graph_rng& rng, std::vector<edge_value>& part) {
+    size_t first = c * rows_per_chunk;
+    size_t last = std::min(n, first + rows_per_chunk);
+    part.reserve((last - first) * (n - 1));
+    for(size_t s = first; s < last; ++s)
+      for(size_t t = 0; t < n; ++t)
+        if(s != t)
+          part.push_back(edge_value({s, t}, rng.uniform()));
+  });
+}
+
+
+/// @brief insert vertices with properties 0..n-1 as one batch
+template<typename graph_id>
+void insert_numbered_vertices(graph_id& g, size_t n) {
+  std::vector<typename graph_id::vertex_property> props(n);
+  for(size_t i = 0; i < n; ++i)
+    props[i] = i;
+  g.insert_vertices(props.begin(), props.end());
+}
+
+/// @brief add vertices 0..n-1 and then the batch of edges to an empty graph
+template<typename graph_id>
+void insert_generated(graph_id& g, size_t n,
+    const std::vector<typename graph_id::edge_value>& batch) {
+  insert_numbered_vertices(g, n);
+  g.insert_edges(batch.begin(), batch.end());
+}
+
+/// @brief create a complete graph of size n
+template<typename graph_id>
+void initialize_complete_graph(graph_id& g, size_t n) {
+  std::vector<typename graph_id::edge_value> batch;
+  complete_edges(batch, n, rand());
+  insert_generated(g, n, batch);
+}
+
+/// @brief create a mesh of size n
+template<typename graph_id>
+void initialize_mesh_graph(graph_id& g, size_t n) {
+  //make n a square number
+  size_t rootn = std::sqrt(n);
+  std::vector<typename graph_id::edge_value> batch;
+  mesh_edges(batch, rootn, rand());
+  insert_generated(g, rootn * rootn, batch);
+}
+
+/// @brief create a random graph of size n: a path through all vertices for
+///        connectivity plus n*sqrt(n)/2 random undirected edges
+template<typename graph_id>
+void initialize_random_graph(graph_id& g, size_t n) {
+  graph_rng rng(rand());
+
+  // add edges for connectivity
+  std::vector<typename graph_id::edge_value> batch;
+  size_t num_edges = n*std::sqrt(n)/2;
+  batch.reserve(2 * (n - 1 + num_edges));
+  for(size_t i=0; i + 1 < n; ++i)
+    push_undirected(batch, i, i+1, rng.uniform());
+
+  //the target is drawn among the n - 1 other vertices, so no retries
+  for(size_t i=0; n > 1 && i < num_edges; ++i) {
+    size_t s = rng.below(n);
+    size_t t = rng.below(n - 1);
+    push_undirected(batch, s, t >= s ? t + 1 : t, rng.uniform());
+  }
+  insert_generated(g, n, batch);
+}
+
+/// @brief create an R-MAT graph with the largest power of two vertices not
+///        above n and 16 directed edges per vertex
+template<typename graph_id>
+void initialize_rmat_graph(graph_id& g, size_t n) {
+  unsigned scale = 0;
+  while(scale < 63 && (size_t(2) << scale) <= n)
+    ++scale;
+  std::vector<typename graph_id::edge_value> batch;
+  rmat_edges(batch, scale, size_t(16) << scale, rand());
+  insert_generated(g, size_t(1) << scale, batch);
+}
+
+/// @brief create a G(n, p) graph of size n with 16 directed edges per vertex
+///        on average
+template<typename graph_id>
+void initialize_gnp_graph(graph_id& g, size_t n) {
+  std::vector<typename graph_id::edge_value> batch;
+  gnp_edges(batch, n, n > 1 ? 16.0 / (n - 1) : 0.0, rand());
+  insert_generated(g, n, batch);
+}
+
+#endif
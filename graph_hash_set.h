@@ -0,0 +1,239 @@
+#ifndef _GRAPH_HASH_SET_H_
+#define _GRAPH_HASH_SET_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Hash function for a pair of integers (e.g., an edge descriptor). The two
+/// halves are combined and run through a 64-bit finalizer so that nearby
+/// pairs spread over the whole table. Replaces boost::hash<std::pair>.
+////////////////////////////////////////////////////////////////////////////////
+struct pair_hash {
+  template<typename A, typename B>
+  size_t operator()(const std::pair<A, B>& p) const {
+    uint64_t x = uint64_t(p.first) * 0x9E3779B97F4A7C15ull ^ uint64_t(p.second);
+    x ^= x >> 32;
+    x *= 0xD6E8FEB86659FD93ull;
+    x ^= x >> 32;
+    return size_t(x);
+  }
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Open-addressing hash set of T*, indexed by a key extracted with KeyOf.
+/// Each slot stores a copy of the key next to the pointer, so probing walks a
+/// flat array and compares keys without dereferencing any element. Collisions
+/// are resolved with linear probing, and erase shifts the following entries
+/// back instead of leaving tombstones, so probe sequences stay short under
+/// churn. The table doubles once it is three quarters full.
+///
+/// Erase invalidates iterators; collect keys first if erasing while walking.
+////////////////////////////////////////////////////////////////////////////////
+template<typename T, typename Key, typename KeyOf, typename Hash,
+         typename Allocator = std::allocator<T*>>
+class open_hash_set {
+
+    struct slot {
+      Key key;   // Key of value, valid only if value is set
+      T* value;  // Element, or nullptr if the slot is empty
+    };
+
+    typedef typename std::allocator_traits<Allocator>::template
+      rebind_alloc<slot> slot_allocator;
+    typedef std::vector<slot, slot_allocator> slot_storage;
+
+  public:
+
+    typedef Key key_type;
+    typedef T* value_type;
+    typedef size_t size_type;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Forward iterator over the occupied slots, dereferencing to T*.
+    ////////////////////////////////////////////////////////////////////////////
+    class const_iterator {
+      public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef T* value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef T* const* pointer;
+        typedef T* const& reference;
+
+        const_iterator() : m_cur(nullptr), m_end(nullptr) { }
+        const_iterator(const slot* cur, const slot* end) : m_cur(cur), m_end(end) {
+          skip();
+        }
+
+        reference operator*() const {return m_cur->value;}
+        pointer operator->() const {return &m_cur->value;}
+
+        const_iterator& operator++() {
+          ++m_cur;
+          skip();
+          return *this;
+        }
+        const_iterator operator++(int) {
+          const_iterator tmp = *this;
+          ++*this;
+          return tmp;
+        }
+
+        bool operator==(const const_iterator& o) const {return m_cur == o.m_cur;}
+        bool operator!=(const const_iterator& o) const {return m_cur != o.m_cur;}
+
+      private:
+        void skip() {
+          while(m_cur != m_end && !m_cur->value)
+            ++m_cur;
+        }
+
+        const slot* m_cur; // Current slot
+        const slot* m_end; // One past the last slot
+        friend class open_hash_set;
+    };
+
+    // Elements are immutable through the set, as in std::set.
+    typedef const_iterator iterator;
+
+    explicit open_hash_set(const Allocator& a = Allocator()) :
+      m_slots(slot_allocator(a)), m_size(0) { }
+
+    open_hash_set(const open_hash_set&) = delete;             ///< Copy is disabled.
+    open_hash_set& operator=(const open_hash_set&) = delete;  ///< Copy is disabled.
+
+    ///@brief Iterators
+    const_iterator begin() const {return make_iterator(0);}
+    const_iterator cbegin() const {return make_iterator(0);}
+    const_iterator end() const {return make_iterator(m_slots.size());}
+    const_iterator cend() const {return make_iterator(m_slots.size());}
+
+    ///@brief Accessors
+    size_t size() const {return m_size;}
+    bool empty() const {return m_size == 0;}
+    size_t bucket_count() const {return m_slots.size();}
+
+    const_iterator find(const Key& k) const {
+      size_t i = probe(k);
+      return i == npos ? end() : make_iterator(i);
+    }
+
+    ///@brief Find the element with the same key as t.
+    const_iterator find(const T* t) const {return find(KeyOf()(t));}
+
+    size_t count(const Key& k) const {return probe(k) == npos ? 0 : 1;}
+
+    ///@brief Modifiers
+    void reserve(size_t n) {
+      size_t cap = 8;
+      while(cap * 3 < n * 4)
+        cap *= 2;
+      if(cap > m_slots.size())
+        rehash(cap);
+    }
+
+    ///@brief Insert t unless an element with the same key is present.
+    ///       Returns whether t was inserted.
+    bool insert(T* t) {
+      if((m_size + 1) * 4 > m_slots.size() * 3)
+        rehash(m_slots.empty() ? 8 : m_slots.size() * 2);
+      Key k = KeyOf()(t);
+      size_t mask = m_slots.size() - 1;
+      for(size_t i = Hash()(k) & mask; ; i = (i + 1) & mask) {
+        slot& s = m_slots[i];
+        if(!s.value) {
+          s.key = k;
+          s.value = t;
+          ++m_size;
+          return true;
+        }
+        if(s.key == k)
+          return false;
+      }
+    }
+
+    ///@brief Insert with a position hint, as in std::set. The hint carries
+    ///       no meaning for a hash table and is ignored; it lets bulk loaders
+    ///       append sorted runs with the same call for either container.
+    void insert(const_iterator, T* t) {insert(t);}
+
+    void erase(const_iterator it) {
+      erase_at(it.m_cur - m_slots.data());
+    }
+
+    size_t erase(const Key& k) {
+      size_t i = probe(k);
+      if(i == npos)
+        return 0;
+      erase_at(i);
+      return 1;
+    }
+
+    ///@brief Erase the element with the same key as t.
+    size_t erase(const T* t) {return erase(KeyOf()(t));}
+
+    void clear() {
+      for(auto& s : m_slots)
+        s.value = nullptr;
+      m_size = 0;
+    }
+
+  private:
+
+    static const size_t npos = size_t(-1);
+
+    const_iterator make_iterator(size_t i) const {
+      return const_iterator(m_slots.data() + i, m_slots.data() + m_slots.size());
+    }
+
+    ///@brief Index of the slot holding key k, or npos.
+    size_t probe(const Key& k) const {
+      if(m_slots.empty())
+        return npos;
+      size_t mask = m_slots.size() - 1;
+      for(size_t i = Hash()(k) & mask; m_slots[i].value; i = (i + 1) & mask)
+        if(m_slots[i].key == k)
+          return i;
+      return npos;
+    }
+
+    ///@brief Empty slot i, then move back every later entry of the probe
+    ///       run whose home slot does not lie between the hole and itself.
+    void erase_at(size_t i) {
+      size_t mask = m_slots.size() - 1;
+      for(size_t j = (i + 1) & mask; m_slots[j].value; j = (j + 1) & mask) {
+        size_t home = Hash()(m_slots[j].key) & mask;
+        if(((j - home) & mask) >= ((j - i) & mask)) {
+          m_slots[i] = m_slots[j];
+          i = j;
+        }
+      }
+      m_slots[i].value = nullptr;
+      --m_size;
+    }
+
+    void rehash(size_t cap) {
+      slot_storage old(cap, slot{Key(), nullptr}, m_slots.get_allocator());
+      old.swap(m_slots);
+      size_t mask = cap - 1;
+      for(auto& s : old) {
+        if(!s.value)
+          continue;
+        size_t i = Hash()(s.key) & mask;
+        while(m_slots[i].value)
+          i = (i + 1) & mask;
+        m_slots[i] = s;
+      }
+    }
+
+    slot_storage m_slots; // Power-of-two table of slots
+    size_t m_size;        // Number of occupied slots
+};
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef _GRAPH_HEAP_H_
+#define _GRAPH_HEAP_H_
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// An indexed D-ary min-heap of keys in [0, n) ordered by a Priority. The
+/// position of every key is tracked so that decrease() can move it up in
+/// O(log_D n). A wider node (D = 4 by default) halves the height of a binary
+/// heap and keeps the children of a node on the same cache line.
+////////////////////////////////////////////////////////////////////////////////
+template<typename Priority, size_t D = 4>
+class d_ary_heap {
+
+  public:
+
+    ///@brief Heap for keys in [0, n).
+    explicit d_ary_heap(size_t n) : m_position(n, npos) { }
+
+    bool empty() const {return m_heap.empty();}
+    size_t size() const {return m_heap.size();}
+    bool contains(size_t k) const {return m_position[k] != npos;}
+
+    ///@brief Key with the smallest priority.
+    size_t top() const {return m_heap.front().second;}
+
+    ///@brief Insert key k, or lower its priority if it is already queued
+    ///       with a larger one.
+    void push(size_t k, const Priority& pr) {
+      size_t i = m_position[k];
+      if(i == npos) {
+        i = m_heap.size();
+        m_heap.emplace_back(pr, k);
+        m_position[k] = i;
+      }
+      else if(pr < m_heap[i].first)
+        m_heap[i].first = pr;
+      else
+        return;
+      sift_up(i);
+    }
+
+    ///@brief Remove and return the key with the smallest priority.
+    size_t pop() {
+      size_t k = m_heap.front().second;
+      m_position[k] = npos;
+      if(m_heap.size() > 1) {
+        m_heap.front() = m_heap.back();
+        m_heap.pop_back();
+        m_position[m_heap.front().second] = 0;
+        sift_down(0);
+      }
+      else
+        m_heap.pop_back();
+      return k;
+    }
+
+  private:
+
+    enum : size_t {npos = size_t(-1)};
+
+    void sift_up(size_t i) {
+      std::pair<Priority, size_t> e = m_heap[i];
+      while(i > 0) {
+        size_t parent = (i - 1) / D;
+        if(!(e.first < m_heap[parent].first))
+          break;
+        place(i, m_heap[parent]);
+        i = parent;
+      }
+      place(i, e);
+    }
+
+    void sift_down(size_t i) {
+      std::pair<Priority, size_t> e = m_heap[i];
+      size_t n = m_heap.size();
+      while(true) {
+        size_t first = i * D + 1;
+        if(first >= n)
+          break;
+        size_t last = first + D < n ? first + D : n;
+        size_t best = first;
+        for(size_t c = first + 1; c < last; ++c)
+          if(m_heap[c].first < m_heap[best].first)
+            best = c;
+        if(!(m_heap[best].first < e.first))
+          break;
+        place(i, m_heap[best]);
+        i = best;
+      }
+      place(i, e);
+    }
+
+    void place(size_t i, const std::pair<Priority, size_t>& e) {
+      m_heap[i] = e;
+      m_position[e.second] = i;
+    }
+
+    std::vector<std::pair<Priority, size_t>> m_heap; // (priority, key) in heap order
+    std::vector<size_t> m_position;                  // Heap index of each key, or npos
+};
+
+#endif
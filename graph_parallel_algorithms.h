@@ -0,0 +1,385 @@
+#ifndef _GRAPH_PARALLEL_ALGORITHMS_H_
+#define _GRAPH_PARALLEL_ALGORITHMS_H_
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "graph_algorithms.h"
+#include "graph_thread_pool.h"
+
+
+// Multithreaded versions of the algorithms in graph_algorithms.h. The graph is
+// only read while they run. Each takes either a thread_pool to run on or a
+// thread count (0 = one per hardware thread) for a pool of its own.
+
+
+///@brief Level-synchronous parallel breadth-first search.
+///
+/// Every level splits the frontier over the pool. A thread claims an
+/// unexplored target by atomically setting its visited flag, records the
+/// parent, and appends the target to its own next-frontier buffer. The buffers
+/// are joined to form the next level. Components are started in the same
+/// order as breadth_first_search; parents may differ from it, but depths do
+/// not. Levels smaller than serial_cutoff are expanded by the caller alone.
+template<typename Graph, typename ParentMap>
+void parallel_breadth_first_search(const Graph& g, ParentMap& p,
+    thread_pool& pool, size_t serial_cutoff = 256) {
+  typedef typename Graph::vertex_descriptor vertex_descriptor;
+  typedef typename Graph::const_vertex_iterator vertex_iterator;
+  typedef typename Graph::const_adj_edge_iterator adj_edge_iterator;
+  typedef typename std::decay<decltype(*g.vertices_cbegin())>::type vertex_ptr;
+
+  // Padded so that threads appending to neighboring buffers do not share a
+  // cache line
+  struct frontier_buffer {
+    std::vector<vertex_ptr> vertices;
+    char pad[64];
+  };
+
+  //setup
+  std::vector<vertex_ptr> vertices;
+  index_vertices(g, vertices);
+  size_t slots = vertices.size();
+  std::unique_ptr<std::atomic<bool>[]> explored(new std::atomic<bool>[slots]);
+  std::vector<vertex_descriptor> parent(slots, vertex_descriptor(-1));
+  std::vector<frontier_buffer> local(pool.size());
+  std::vector<vertex_ptr> frontier, next;
+
+  for(size_t vd = 0; vd < slots; ++vd)
+    explored[vd].store(vertices[vd] == nullptr, std::memory_order_relaxed);
+
+  // Expand frontier[b, e) on thread tid
+  auto expand = [&](size_t tid, size_t b, size_t e) {
+    auto& out = local[tid].vertices;
+    for(size_t i = b; i < e; ++i) {
+      vertex_ptr v = frontier[i];
+      for(adj_edge_iterator aei = v->begin(); aei != v->end(); ++aei) {
+        vertex_descriptor t = (*aei)->target();
+        if(t < slots && !explored[t].load(std::memory_order_relaxed) &&
+            !explored[t].exchange(true, std::memory_order_relaxed)) {
+          //discovery edge
+          parent[t] = v->descriptor();
+          out.push_back(vertices[t]);
+        }
+      }
+    }
+  };
+
+  //for each CC
+  for(vertex_iterator vi = g.vertices_cbegin(); vi != g.vertices_cend(); ++vi) {
+    vertex_descriptor vd = (*vi)->descriptor();
+    if(explored[vd].load(std::memory_order_relaxed))
+      continue;
+    explored[vd].store(true, std::memory_order_relaxed);
+    frontier.assign(1, *vi);
+    while(!frontier.empty()) {
+      if(frontier.size() < serial_cutoff)
+        expand(0, 0, frontier.size());
+      else
+        pool.parallel_for(frontier.size(), 64, expand);
+
+      next.clear();
+      for(auto& l : local) {
+        next.insert(next.end(), l.vertices.begin(), l.vertices.end());
+        l.vertices.clear();
+      }
+      frontier.swap(next);
+    }
+  }
+
+  //publish
+  reset_parent_map(p, slots);
+  for(vertex_iterator vi = g.vertices_cbegin(); vi != g.vertices_cend(); ++vi) {
+    vertex_descriptor vd = (*vi)->descriptor();
+    p[vd] = parent[vd];
+  }
+}
+
+///@brief Parallel breadth-first search on a pool of num_threads threads.
+template<typename Graph, typename ParentMap>
+void parallel_breadth_first_search(const Graph& g, ParentMap& p,
+    size_t num_threads = 0) {
+  thread_pool pool(num_threads);
+  parallel_breadth_first_search(g, p, pool);
+}
+
+
+///@brief A bucket width for delta_stepping_shortest_paths: the largest edge
+///       weight divided by the average out-degree (1 if all weights are 0).
+template<typename Graph>
+double default_delta(const Graph& g) {
+  double max_weight = 0;
+  for(auto ei = g.edges_cbegin(); ei != g.edges_cend(); ++ei)
+    max_weight = std::max(max_weight, double((*ei)->property()));
+  double avg_degree = g.num_vertices() ?
+    double(g.num_edges()) / g.num_vertices() : 1;
+  return max_weight > 0 ? max_weight / std::max(1.0, avg_degree) : 1;
+}
+
+
+///@brief Parallel delta-stepping shortest paths from the vertices in
+///       [first, last), with the same forest contract as
+///       dijkstra_shortest_paths. Weights must be non-negative.
+///
+/// Tentative distances are kept in buckets of width delta. The lowest
+/// non-empty bucket is expanded repeatedly over its light edges (weight <=
+/// delta) until it stays empty, then the heavy edges of every vertex removed
+/// from it are relaxed once. Each vertex is owned by thread vd % size(): a
+/// thread only expands its own vertices and sends each relaxation to the
+/// owner of the target, which applies it after the next barrier. Owners are
+/// the only writers of their vertices' distance, parent and bucket, so no
+/// atomics are needed. A small delta approaches Dijkstra, a large one
+/// Bellman-Ford; delta = 0 picks default_delta(g).
+template<typename Graph, typename RootIterator, typename ParentMap,
+         typename DistanceMap>
+void delta_stepping_shortest_paths(const Graph& g, RootIterator first,
+    RootIterator last, ParentMap& p, DistanceMap& d, double delta,
+    thread_pool& pool) {
+  typedef typename Graph::vertex_descriptor vertex_descriptor;
+  typedef typename Graph::const_vertex_iterator vertex_iterator;
+  typedef typename Graph::const_adj_edge_iterator adj_edge_iterator;
+  typedef typename edge_weight<Graph>::type weight;
+  typedef typename std::decay<decltype(*g.vertices_cbegin())>::type vertex_ptr;
+  const weight inf = std::numeric_limits<weight>::max();
+  const size_t none = size_t(-1);
+
+  struct request {
+    vertex_descriptor target;
+    weight dist;
+    vertex_descriptor source;
+  };
+
+  struct thread_state {
+    std::vector<std::vector<vertex_descriptor>> buckets; // Owned vertices by bucket
+    std::vector<vertex_descriptor> current;   // Bucket being expanded
+    std::vector<vertex_descriptor> settled;   // Removed from the current bucket
+    std::vector<std::vector<request>> out;    // Relaxations for each owner
+    char pad[64];                             // Keeps neighbors off this line
+  };
+
+  //setup
+  if(delta <= 0)
+    delta = default_delta(g);
+  std::vector<vertex_ptr> vertices;
+  index_vertices(g, vertices);
+  size_t slots = vertices.size();
+  size_t threads = pool.size();
+  std::vector<weight> dist(slots, inf);
+  std::vector<vertex_descriptor> parent(slots, vertex_descriptor(-1));
+  std::vector<size_t> queued_in(slots, none);  // Bucket holding each vertex
+  std::vector<thread_state> state(threads);
+  for(auto& st : state)
+    st.out.resize(threads);
+
+  auto bucket_of = [delta](weight w) {return size_t(double(w) / delta);};
+
+  // Owner-side: put v in the bucket of its new distance
+  auto enqueue = [&](thread_state& st, vertex_descriptor v) {
+    size_t b = bucket_of(dist[v]);
+    if(queued_in[v] == b)
+      return;
+    if(st.buckets.size() <= b)
+      st.buckets.resize(b + 1);
+    st.buckets[b].push_back(v);
+    queued_in[v] = b;
+  };
+
+  // Send relaxations of v's light or heavy out-edges to their owners
+  auto relax = [&](thread_state& st, vertex_descriptor v, bool light) {
+    vertex_ptr u = vertices[v];
+    for(adj_edge_iterator aei = u->begin(); aei != u->end(); ++aei) {
+      vertex_descriptor t = (*aei)->target();
+      weight w = (*aei)->property();
+      if(t >= slots || !vertices[t] || (double(w) <= delta) != light)
+        continue;
+      st.out[t % threads].push_back({t, dist[v] + w, v});
+    }
+  };
+
+  // Apply every relaxation sent to thread tid
+  auto apply = [&](size_t tid) {
+    thread_state& st = state[tid];
+    for(auto& sender : state) {
+      for(auto& r : sender.out[tid]) {
+        if(r.dist < dist[r.target]) {
+          dist[r.target] = r.dist;
+          parent[r.target] = r.source;
+          enqueue(st, r.target);
+        }
+      }
+      sender.out[tid].clear();
+    }
+  };
+
+  // Lowest bucket index >= b that some thread has entries in, or none
+  auto next_bucket = [&](size_t b) {
+    size_t best = none;
+    for(auto& st : state)
+      for(size_t i = b; i < st.buckets.size() && i < best; ++i)
+        if(!st.buckets[i].empty()) {
+          best = i;
+          break;
+        }
+    return best;
+  };
+
+  for(; first != last; ++first) {
+    vertex_descriptor root = *first;
+    if(root >= slots || !vertices[root] || dist[root] != inf)
+      continue;
+    dist[root] = weight();
+    enqueue(state[root % threads], root);
+
+    for(size_t cur = next_bucket(0); cur != none; cur = next_bucket(cur + 1)) {
+      //light edges, until the bucket stays empty
+      while(next_bucket(cur) == cur) {
+        pool.run([&](size_t tid) {
+          thread_state& st = state[tid];
+          if(st.buckets.size() <= cur)
+            return;
+          st.current.swap(st.buckets[cur]);
+          for(auto v : st.current) {
+            if(queued_in[v] != cur)
+              continue;  //stale, v has moved to another bucket
+            queued_in[v] = none;
+            st.settled.push_back(v);
+            relax(st, v, true);
+          }
+          st.current.clear();
+        });
+        pool.run(apply);
+      }
+
+      //heavy edges of everything settled from this bucket
+      pool.run([&](size_t tid) {
+        thread_state& st = state[tid];
+        for(auto v : st.settled)
+          relax(st, v, false);
+        st.settled.clear();
+      });
+      pool.run(apply);
+    }
+  }
+
+  //publish
+  reset_parent_map(p, slots);
+  reset_distance_map(d, slots, inf);
+  for(vertex_iterator vi = g.vertices_cbegin(); vi != g.vertices_cend(); ++vi) {
+    vertex_descriptor vd = (*vi)->descriptor();
+    p[vd] = parent[vd];
+    d[vd] = dist[vd];
+  }
+}
+
+///@brief Parallel delta-stepping shortest paths from a single source.
+template<typename Graph, typename ParentMap, typename DistanceMap>
+void delta_stepping_shortest_paths(const Graph& g,
+    typename Graph::vertex_descriptor source, ParentMap& p, DistanceMap& d,
+    double delta, thread_pool& pool) {
+  delta_stepping_shortest_paths(g, &source, &source + 1, p, d, delta, pool);
+}
+
+///@brief Parallel delta-stepping shortest paths from a single source on a
+///       pool of num_threads threads.
+template<typename Graph, typename ParentMap, typename DistanceMap>
+void delta_stepping_shortest_paths(const Graph& g,
+    typename Graph::vertex_descriptor source, ParentMap& p, DistanceMap& d,
+    double delta = 0, size_t num_threads = 0) {
+  thread_pool pool(num_threads);
+  delta_stepping_shortest_paths(g, source, p, d, delta, pool);
+}
+
+
+///@brief Parallel connected components by lock-free union-find.
+///
+/// Edges are taken as undirected, so for a directed graph these are the
+/// weakly connected components. Every thread walks the out-edges of a range
+/// of vertices and unites their endpoints. A union links the larger root
+/// under the smaller one with a compare-and-swap, retrying if either root
+/// changed in the meantime, and finds halve their paths as they go. Since
+/// parents only ever point to smaller descriptors, c[vd] ends up as the
+/// smallest descriptor in vd's component. Returns the number of components.
+template<typename Graph, typename ComponentMap>
+size_t connected_components(const Graph& g, ComponentMap& c,
+    thread_pool& pool) {
+  typedef typename Graph::vertex_descriptor vertex_descriptor;
+  typedef typename Graph::const_vertex_iterator vertex_iterator;
+  typedef typename Graph::const_adj_edge_iterator adj_edge_iterator;
+  typedef typename std::decay<decltype(*g.vertices_cbegin())>::type vertex_ptr;
+
+  //setup, every vertex starts as its own root
+  std::vector<vertex_ptr> vertices;
+  index_vertices(g, vertices);
+  size_t slots = vertices.size();
+  std::unique_ptr<std::atomic<vertex_descriptor>[]> parent(
+      new std::atomic<vertex_descriptor>[slots]);
+  for(size_t vd = 0; vd < slots; ++vd)
+    parent[vd].store(vd, std::memory_order_relaxed);
+
+  auto find = [&](vertex_descriptor x) {
+    while(true) {
+      vertex_descriptor p = parent[x].load(std::memory_order_relaxed);
+      if(p == x)
+        return x;
+      vertex_descriptor gp = parent[p].load(std::memory_order_relaxed);
+      if(p != gp)
+        parent[x].compare_exchange_weak(p, gp, std::memory_order_relaxed);
+      x = gp;
+    }
+  };
+
+  auto unite = [&](vertex_descriptor a, vertex_descriptor b) {
+    while(true) {
+      a = find(a);
+      b = find(b);
+      if(a == b)
+        return;
+      if(a < b)
+        std::swap(a, b);
+      //a is the larger root, hang it under b unless it stopped being a root
+      vertex_descriptor expected = a;
+      if(parent[a].compare_exchange_strong(expected, b, std::memory_order_relaxed))
+        return;
+    }
+  };
+
+  pool.parallel_for(slots, 256, [&](size_t, size_t b, size_t e) {
+    for(size_t vd = b; vd < e; ++vd) {
+      if(!vertices[vd])
+        continue;
+      for(adj_edge_iterator aei = vertices[vd]->begin();
+          aei != vertices[vd]->end(); ++aei) {
+        vertex_descriptor t = (*aei)->target();
+        if(t < slots && vertices[t])
+          unite(vd, t);
+      }
+    }
+  });
+
+  //publish, flattening every path to its root
+  size_t components = 0;
+  reset_parent_map(c, slots);
+  for(vertex_iterator vi = g.vertices_cbegin(); vi != g.vertices_cend(); ++vi) {
+    vertex_descriptor vd = (*vi)->descriptor();
+    vertex_descriptor root = find(vd);
+    c[vd] = root;
+    if(root == vd)
+      ++components;
+  }
+  return components;
+}
+
+///@brief Parallel connected components on a pool of num_threads threads.
+template<typename Graph, typename ComponentMap>
+size_t connected_components(const Graph& g, ComponentMap& c,
+    size_t num_threads = 0) {
+  thread_pool pool(num_threads);
+  return connected_components(g, c, pool);
+}
+
+#endif
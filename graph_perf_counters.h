@@ -0,0 +1,175 @@
+#ifndef _GRAPH_PERF_COUNTERS_H_
+#define _GRAPH_PERF_COUNTERS_H_
+
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+///@brief Events counted by perf_counters.
+enum class perf_event {
+  cycles,
+  instructions,
+  llc_misses,     // Last level cache misses
+  branch_misses,
+  page_faults
+};
+
+enum {num_perf_events = 5};
+
+inline const char* perf_event_name(perf_event e) {
+  static const char* names[] = {"cycles", "instructions", "llc_misses",
+    "branch_misses", "page_faults"};
+  return names[int(e)];
+}
+
+
+///@brief Event counts of one measured interval.
+struct perf_reading {
+  uint64_t count[num_perf_events];
+  bool valid[num_perf_events];  // Whether the event could be counted
+
+  perf_reading() {
+    std::memset(count, 0, sizeof(count));
+    std::memset(valid, 0, sizeof(valid));
+  }
+
+  bool any() const {
+    for(int e = 0; e < num_perf_events; ++e)
+      if(valid[e])
+        return true;
+    return false;
+  }
+};
+
+///@brief Print the valid counts of r as "name: count" pairs, plus the
+///       instructions per cycle when both are known. Prints nothing if no
+///       event was counted.
+inline std::ostream& operator<<(std::ostream& os, const perf_reading& r) {
+  bool first = true;
+  for(int e = 0; e < num_perf_events; ++e)
+    if(r.valid[e]) {
+      os << (first ? "" : "  ") << perf_event_name(perf_event(e)) << ": " << r.count[e];
+      first = false;
+    }
+  int c = int(perf_event::cycles), i = int(perf_event::instructions);
+  if(r.valid[c] && r.valid[i] && r.count[c])
+    os << "  IPC: " << double(r.count[i]) / r.count[c];
+  return os;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Hardware and software event counters of the calling thread, in user space,
+/// read with perf_event_open(2) around a start()/stop() interval. Each event
+/// is opened on its own, so that whatever the kernel, the CPU (virtual
+/// machines often expose no hardware events) and perf_event_paranoid allow
+/// is still counted; the others are reported as not valid. Where
+/// perf_event_open does not exist nothing is counted and stop() returns an
+/// empty reading, so callers need no special casing.
+///
+/// When the kernel multiplexes more events than the PMU has counters, counts
+/// are scaled by the fraction of the interval each event was scheduled; an
+/// event that was never scheduled has no count and is reported as not valid.
+////////////////////////////////////////////////////////////////////////////////
+class perf_counters {
+
+  public:
+
+    ///@brief Open the counters. Nothing is counted until start().
+    perf_counters() {
+      for(int e = 0; e < num_perf_events; ++e)
+        m_fds[e] = open_event(perf_event(e));
+    }
+
+    ~perf_counters() {
+#ifdef __linux__
+      for(int fd : m_fds)
+        if(fd >= 0)
+          close(fd);
+#endif
+    }
+
+    perf_counters(const perf_counters&) = delete;
+    perf_counters& operator=(const perf_counters&) = delete;
+
+    ///@brief Whether event e, or any event, can be counted.
+    bool available(perf_event e) const {return m_fds[int(e)] >= 0;}
+    bool available() const {
+      for(int fd : m_fds)
+        if(fd >= 0)
+          return true;
+      return false;
+    }
+
+    ///@brief Zero the counters and start counting.
+    void start() {
+#ifdef __linux__
+      for(int fd : m_fds)
+        if(fd >= 0)
+          ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+      for(int fd : m_fds)
+        if(fd >= 0)
+          ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+
+    ///@brief Stop counting and return the counts since start().
+    perf_reading stop() {
+      perf_reading r;
+#ifdef __linux__
+      for(int fd : m_fds)
+        if(fd >= 0)
+          ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+      for(int e = 0; e < num_perf_events; ++e) {
+        //value, time enabled, time running
+        uint64_t v[3];
+        if(m_fds[e] < 0 || read(m_fds[e], v, sizeof(v)) != sizeof(v) || v[2] == 0)
+          continue;
+        r.valid[e] = true;
+        r.count[e] = v[2] < v[1] ? uint64_t(double(v[0]) * v[1] / v[2]) : v[0];
+      }
+#endif
+      return r;
+    }
+
+  private:
+    ///@brief File descriptor counting e for this thread, or -1.
+    static int open_event(perf_event e) {
+#ifdef __linux__
+      perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = PERF_TYPE_HARDWARE;
+      switch(e) {
+        case perf_event::cycles: attr.config = PERF_COUNT_HW_CPU_CYCLES; break;
+        case perf_event::instructions: attr.config = PERF_COUNT_HW_INSTRUCTIONS; break;
+        case perf_event::llc_misses: attr.config = PERF_COUNT_HW_CACHE_MISSES; break;
+        case perf_event::branch_misses: attr.config = PERF_COUNT_HW_BRANCH_MISSES; break;
+        case perf_event::page_faults:
+          attr.type = PERF_TYPE_SOFTWARE;
+          attr.config = PERF_COUNT_SW_PAGE_FAULTS;
+          break;
+      }
+      attr.disabled = 1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+      return int(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#else
+      (void)e;
+      return -1;
+#endif
+    }
+
+    int m_fds[num_perf_events];  // One descriptor per event, -1 if unavailable
+};
+
+#endif
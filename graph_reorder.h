@@ -0,0 +1,161 @@
+#ifndef _GRAPH_REORDER_H_
+#define _GRAPH_REORDER_H_
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "graph_algorithms.h"
+
+
+///@brief Orders computed by vertex_ordering().
+enum class vertex_order {
+  reverse_cuthill_mckee,  // Bandwidth-reducing order over in- and out-edges
+  degree_descending,      // Hubs first
+  bfs                     // Discovery order of breadth_first_search
+};
+
+///@brief Mapping between the descriptors of a graph and of its relabeled copy.
+struct vertex_relabeling {
+  std::vector<size_t> new_to_old;  // Old descriptor of each new descriptor
+  std::vector<size_t> old_to_new;  // New descriptor by old one, -1 if none
+};
+
+
+///@brief Old descriptors of the vertices of g listed in the given order.
+///
+/// Reverse Cuthill-McKee treats the graph as undirected. Each component
+/// starts at an unvisited vertex of least degree, neighbours are visited
+/// breadth-first by increasing degree, and the final order is reversed. This
+/// keeps the descriptors of adjacent vertices close together. The degree
+/// order puts the hubs, which most edges lead to, in one dense block. The BFS
+/// order lays out each frontier together. Ties are broken by descriptor.
+template<typename Graph>
+std::vector<size_t> vertex_ordering(const Graph& g, vertex_order order) {
+  typedef typename std::decay<decltype(*g.vertices_cbegin())>::type vertex_ptr;
+
+  std::vector<vertex_ptr> index;
+  index_vertices(g, index);
+  std::vector<vertex_ptr> live;
+  live.reserve(g.num_vertices());
+  for(auto v : index)
+    if(v)
+      live.push_back(v);
+  auto degree = [](vertex_ptr v) {return v->out_degree() + v->in_degree();};
+
+  std::vector<size_t> result;
+  result.reserve(live.size());
+  if(order == vertex_order::degree_descending) {
+    std::stable_sort(live.begin(), live.end(), [&](vertex_ptr a, vertex_ptr b) {
+      return degree(a) > degree(b);
+    });
+    for(auto v : live)
+      result.push_back(v->descriptor());
+  }
+  else if(order == vertex_order::bfs) {
+    std::vector<bool> seen(index.size(), false);
+    for(auto root : live) {
+      if(seen[root->descriptor()])
+        continue;
+      size_t head = result.size();
+      seen[root->descriptor()] = true;
+      result.push_back(root->descriptor());
+      while(head != result.size()) {
+        vertex_ptr v = index[result[head++]];
+        for(auto ai = v->cbegin(); ai != v->cend(); ++ai) {
+          size_t t = (*ai)->target();
+          if(t < index.size() && index[t] && !seen[t]) {
+            seen[t] = true;
+            result.push_back(t);
+          }
+        }
+      }
+    }
+  }
+  else {
+    //roots are tried in increasing degree
+    std::vector<vertex_ptr> roots(live);
+    std::stable_sort(roots.begin(), roots.end(), [&](vertex_ptr a, vertex_ptr b) {
+      return degree(a) < degree(b);
+    });
+    std::vector<bool> seen(index.size(), false);
+    std::vector<vertex_ptr> next;
+    auto visit = [&](size_t t) {
+      if(t < index.size() && index[t] && !seen[t]) {
+        seen[t] = true;
+        next.push_back(index[t]);
+      }
+    };
+    for(auto root : roots) {
+      if(seen[root->descriptor()])
+        continue;
+      size_t head = result.size();
+      seen[root->descriptor()] = true;
+      result.push_back(root->descriptor());
+      while(head != result.size()) {
+        vertex_ptr v = index[result[head++]];
+        next.clear();
+        for(auto ai = v->cbegin(); ai != v->cend(); ++ai)
+          visit((*ai)->target());
+        for(auto ai = v->in_cbegin(); ai != v->in_cend(); ++ai)
+          visit((*ai)->source());
+        std::sort(next.begin(), next.end(), [&](vertex_ptr a, vertex_ptr b) {
+          return degree(a) != degree(b) ? degree(a) < degree(b)
+                                        : a->descriptor() < b->descriptor();
+        });
+        for(auto n : next)
+          result.push_back(n->descriptor());
+      }
+    }
+    std::reverse(result.begin(), result.end());
+  }
+  return result;
+}
+
+
+///@brief Copy g into out with vertex new_to_old[i] renamed to i, filling in
+///       map. new_to_old must list every vertex of g once. out is cleared
+///       first and filled with the bulk inserts, so its vertices, edges and
+///       adjacency lists are also allocated in the new order.
+template<typename Graph>
+void relabel(const Graph& g, const std::vector<size_t>& new_to_old, Graph& out,
+    vertex_relabeling& map) {
+  typedef typename std::decay<decltype(*g.vertices_cbegin())>::type vertex_ptr;
+  typedef typename Graph::edge_value edge_value;
+
+  std::vector<vertex_ptr> index;
+  index_vertices(g, index);
+  map.new_to_old = new_to_old;
+  map.old_to_new.assign(index.size(), size_t(-1));
+  for(size_t i = 0; i < new_to_old.size(); ++i)
+    map.old_to_new[new_to_old[i]] = i;
+
+  std::vector<typename Graph::vertex_property> properties;
+  properties.reserve(new_to_old.size());
+  std::vector<edge_value> edges;
+  edges.reserve(g.num_edges());
+  for(size_t vd : new_to_old) {
+    vertex_ptr v = index[vd];
+    properties.push_back(v->property());
+    for(auto ai = v->cbegin(); ai != v->cend(); ++ai) {
+      size_t t = (*ai)->target();
+      if(t < index.size() && index[t])
+        edges.emplace_back(std::make_pair(map.old_to_new[vd], map.old_to_new[t]),
+            (*ai)->property());
+    }
+  }
+
+  out.clear();
+  out.insert_vertices(properties.begin(), properties.end());
+  out.insert_edges(edges.begin(), edges.end());
+}
+
+///@brief Copy g into out relabeled in the given order, see vertex_ordering()
+///       and relabel().
+template<typename Graph>
+void reorder(const Graph& g, vertex_order order, Graph& out, vertex_relabeling& map) {
+  relabel(g, vertex_ordering(g, order), out, map);
+}
+
+#endif
@@ -0,0 +1,160 @@
+#ifndef _GRAPH_SIMD_H_
+#define _GRAPH_SIMD_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Linear scans over contiguous arrays of descriptors, vectorized with AVX2
+/// (4 descriptors per compare) when the compiler targets it (e.g. -mavx2 or
+/// -march=native), with SSE2 (2 per compare, the x86-64 baseline) otherwise,
+/// and plain loops elsewhere. Used by the structure-of-arrays layout of
+/// graph_vector, and by graph_compressed to decode its varint lists.
+////////////////////////////////////////////////////////////////////////////////
+
+///@brief Name of the instruction set the scans were compiled for.
+inline const char* simd_scan_isa() {
+#if defined(__AVX2__)
+  return "AVX2";
+#elif defined(__SSE2__)
+  return "SSE2";
+#else
+  return "scalar";
+#endif
+}
+
+///@brief Index of the first i < n with a[i] == key, or n.
+inline size_t simd_find(const size_t* a, size_t n, size_t key) {
+  size_t i = 0;
+#if defined(__AVX2__)
+  static_assert(sizeof(size_t) == 8, "64-bit descriptors expected");
+  __m256i k = _mm256_set1_epi64x(key);
+  for(; i + 8 <= n; i += 8) {
+    __m256i c0 = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*)(a + i)), k);
+    __m256i c1 = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*)(a + i + 4)), k);
+    int m = _mm256_movemask_pd(_mm256_castsi256_pd(c0)) |
+            _mm256_movemask_pd(_mm256_castsi256_pd(c1)) << 4;
+    if(m)
+      return i + __builtin_ctz(m);
+  }
+#elif defined(__SSE2__)
+  static_assert(sizeof(size_t) == 8, "64-bit descriptors expected");
+  // SSE2 has no 64-bit compare: compare the 32-bit halves and require both
+  __m128i k = _mm_set1_epi64x(key);
+  for(; i + 4 <= n; i += 4) {
+    __m128i c0 = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(a + i)), k);
+    __m128i c1 = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(a + i + 2)), k);
+    c0 = _mm_and_si128(c0, _mm_shuffle_epi32(c0, _MM_SHUFFLE(2, 3, 0, 1)));
+    c1 = _mm_and_si128(c1, _mm_shuffle_epi32(c1, _MM_SHUFFLE(2, 3, 0, 1)));
+    int m = _mm_movemask_pd(_mm_castsi128_pd(c0)) |
+            _mm_movemask_pd(_mm_castsi128_pd(c1)) << 2;
+    if(m)
+      return i + __builtin_ctz(m);
+  }
+#endif
+  for(; i < n; ++i)
+    if(a[i] == key)
+      return i;
+  return n;
+}
+
+///@brief Index of the first i < n with a[i] == ka and b[i] == kb, or n.
+inline size_t simd_find_pair(const size_t* a, const size_t* b, size_t n,
+    size_t ka, size_t kb) {
+  size_t i = 0;
+#if defined(__AVX2__)
+  __m256i ka4 = _mm256_set1_epi64x(ka);
+  __m256i kb4 = _mm256_set1_epi64x(kb);
+  for(; i + 4 <= n; i += 4) {
+    __m256i c = _mm256_and_si256(
+        _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*)(a + i)), ka4),
+        _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*)(b + i)), kb4));
+    int m = _mm256_movemask_pd(_mm256_castsi256_pd(c));
+    if(m)
+      return i + __builtin_ctz(m);
+  }
+#elif defined(__SSE2__)
+  __m128i ka2 = _mm_set1_epi64x(ka);
+  __m128i kb2 = _mm_set1_epi64x(kb);
+  for(; i + 2 <= n; i += 2) {
+    __m128i c = _mm_and_si128(
+        _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(a + i)), ka2),
+        _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(b + i)), kb2));
+    c = _mm_and_si128(c, _mm_shuffle_epi32(c, _MM_SHUFFLE(2, 3, 0, 1)));
+    int m = _mm_movemask_pd(_mm_castsi128_pd(c));
+    if(m)
+      return i + __builtin_ctz(m);
+  }
+#endif
+  for(; i < n; ++i)
+    if(a[i] == ka && b[i] == kb)
+      return i;
+  return n;
+}
+
+///@brief Whether none of the simd_window_width bytes at p has its high bit
+///       set, i.e. whether they are as many one-byte varints. The window is
+///       one register wide, or a single byte without SIMD.
+#if defined(__AVX2__)
+const size_t simd_window_width = 32;
+inline bool window_is_one_byte(const uint8_t* p) {
+  return !_mm256_movemask_epi8(_mm256_loadu_si256((const __m256i*)p));
+}
+#elif defined(__SSE2__)
+const size_t simd_window_width = 16;
+inline bool window_is_one_byte(const uint8_t* p) {
+  return !_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)p));
+}
+#else
+const size_t simd_window_width = 1;
+inline bool window_is_one_byte(const uint8_t* p) {
+  return !(*p & 0x80);
+}
+#endif
+
+///@brief Decode up to max varints (7 bits per byte, high bit set on all but
+///       the last byte) from [p, end) as gaps added to a running base, and
+///       write the running values to out. Advances p past the decoded bytes
+///       and leaves base at the last value; returns how many were written.
+///       Reads nothing at or past end.
+///
+/// The next simd_window_width bytes are tested with window_is_one_byte().
+/// When the window is all one-byte gaps -- the bulk of a long list in a graph
+/// with locality -- it is summed in a straight loop; otherwise the varints up
+/// to the end of the window are decoded one byte at a time, as are lists
+/// shorter than a window.
+inline size_t simd_decode_gaps(const uint8_t*& p, const uint8_t* end, size_t& base,
+    size_t* out, size_t max) {
+  size_t n = 0;
+  while(n < max && p != end) {
+    const uint8_t* stop = end;
+    if(size_t(end - p) >= simd_window_width) {
+      if(window_is_one_byte(p)) {
+        size_t run = std::min(simd_window_width, max - n);
+        for(size_t i = 0; i < run; ++i)
+          out[n + i] = base += p[i];
+        p += run;
+        n += run;
+        continue;
+      }
+      stop = p + simd_window_width;
+    }
+    for(; p < stop && n < max; ++n) {
+      uint64_t v = *p & 0x7f;
+      for(unsigned shift = 7; *p++ & 0x80; shift += 7)
+        v |= uint64_t(*p & 0x7f) << shift;
+      out[n] = base += v;
+    }
+  }
+  return n;
+}
+
+#endif
@@ -0,0 +1,147 @@
+#ifndef _GRAPH_SLOT_MAP_H_
+#define _GRAPH_SLOT_MAP_H_
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Dense storage of T* indexed directly by descriptor. Slot i holds the object
+/// whose descriptor is i, or nullptr (a tombstone) if there is none. Since a
+/// graph hands out descriptors monotonically and never recycles them, a slot
+/// is never reused until clear(), so the tombstone alone tells a stale
+/// descriptor apart from a live one and no generation counter is needed.
+///
+/// Lookup is a bounds check and an array load; iteration visits live
+/// objects in descriptor order, skipping tombstones.
+////////////////////////////////////////////////////////////////////////////////
+template<typename T, typename Allocator = std::allocator<T*>>
+class slot_map {
+
+    typedef std::vector<T*, Allocator> slot_storage;
+
+  public:
+
+    typedef size_t key_type;
+    typedef T* value_type;
+    typedef size_t size_type;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Forward iterator over the live slots. Dereferences to T* like the
+    /// iterators of the standard containers previously used for vertices.
+    ////////////////////////////////////////////////////////////////////////////
+    class const_iterator {
+      public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef T* value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef T* const* pointer;
+        typedef T* const& reference;
+
+        const_iterator() : m_cur(nullptr), m_end(nullptr) { }
+        const_iterator(T* const* cur, T* const* end) : m_cur(cur), m_end(end) {
+          skip();
+        }
+
+        reference operator*() const {return *m_cur;}
+        pointer operator->() const {return m_cur;}
+
+        const_iterator& operator++() {
+          ++m_cur;
+          skip();
+          return *this;
+        }
+        const_iterator operator++(int) {
+          const_iterator tmp = *this;
+          ++*this;
+          return tmp;
+        }
+
+        bool operator==(const const_iterator& o) const {return m_cur == o.m_cur;}
+        bool operator!=(const const_iterator& o) const {return m_cur != o.m_cur;}
+
+      private:
+        void skip() {
+          while(m_cur != m_end && !*m_cur)
+            ++m_cur;
+        }
+
+        T* const* m_cur; // Current slot
+        T* const* m_end; // One past the last slot
+        friend class slot_map;
+    };
+
+    // Elements are pointers owned by the caller, so mutation goes through
+    // insert/erase and both iterator types are the same.
+    typedef const_iterator iterator;
+
+    explicit slot_map(const Allocator& a = Allocator()) :
+      m_slots(a), m_size(0) { }
+
+    ///@brief Iterators
+    const_iterator begin() const {return make_iterator(0);}
+    const_iterator cbegin() const {return make_iterator(0);}
+    const_iterator end() const {return make_iterator(m_slots.size());}
+    const_iterator cend() const {return make_iterator(m_slots.size());}
+
+    ///@brief Accessors
+    size_t size() const {return m_size;}
+    bool empty() const {return m_size == 0;}
+
+    ///@brief Number of slots, i.e., one past the largest key ever inserted
+    ///       since the last clear().
+    size_t capacity() const {return m_slots.size();}
+
+    ///@brief Object stored for key k, or nullptr if there is none.
+    T* get(key_type k) const {
+      return k < m_slots.size() ? m_slots[k] : nullptr;
+    }
+
+    const_iterator find(key_type k) const {
+      return get(k) ? const_iterator(&m_slots[k], m_slots.data() + m_slots.size())
+                    : end();
+    }
+
+    size_t count(key_type k) const {return get(k) ? 1 : 0;}
+
+    ///@brief Modifiers
+    void reserve(size_t n) {m_slots.reserve(n);}
+
+    ///@brief Store t under key k. The slot must be empty.
+    void insert(key_type k, T* t) {
+      if(k >= m_slots.size())
+        m_slots.resize(k + 1, nullptr);
+      m_slots[k] = t;
+      ++m_size;
+    }
+
+    ///@brief Tombstone the slot at k. Returns whether it was live.
+    size_t erase(key_type k) {
+      if(!get(k))
+        return 0;
+      m_slots[k] = nullptr;
+      --m_size;
+      return 1;
+    }
+
+    void erase(const_iterator it) {
+      erase(key_type(it.m_cur - m_slots.data()));
+    }
+
+    void clear() {
+      m_slots.clear();
+      m_size = 0;
+    }
+
+  private:
+    const_iterator make_iterator(size_t i) const {
+      return const_iterator(m_slots.data() + i, m_slots.data() + m_slots.size());
+    }
+
+    slot_storage m_slots; // Object pointer (or nullptr) for each key
+    size_t m_size;        // Number of live slots
+};
+
+#endif
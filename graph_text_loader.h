@@ -0,0 +1,330 @@
+#ifndef _GRAPH_TEXT_LOADER_H_
+#define _GRAPH_TEXT_LOADER_H_
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "graph_thread_pool.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Number parsing for the text loader. std::from_chars would do, but it is
+/// C++17 (and floating point support came later still), so integers are
+/// parsed by hand and floating point values take an exact fast path when the
+/// mantissa has at most 15 digits and the decimal exponent is at most 22 --
+/// both are then exact doubles, so a single division or multiplication gives
+/// the correctly rounded result, as operator>> would. Anything else falls
+/// back to strtod on a copy of the token.
+///
+/// Each parser skips leading whitespace, parses one token ending before
+/// end, and returns the position after it, or nullptr if there is no valid
+/// token. Integers that do not fit the target type are not valid.
+////////////////////////////////////////////////////////////////////////////////
+namespace text_parse {
+
+inline bool is_space(char c) {
+  return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+inline const char* skip_space(const char* p, const char* end) {
+  while(p != end && is_space(*p))
+    ++p;
+  return p;
+}
+
+template<typename T>
+typename std::enable_if<std::is_integral<T>::value, const char*>::type
+parse(const char* p, const char* end, T& out) {
+  p = skip_space(p, end);
+  bool neg = false;
+  if(p != end && (*p == '-' || *p == '+')) {
+    neg = *p == '-';
+    ++p;
+  }
+  if(p == end || unsigned(*p - '0') > 9)
+    return nullptr;
+  uint64_t v = 0;
+  for(; p != end && unsigned(*p - '0') <= 9; ++p) {
+    unsigned d = unsigned(*p - '0');
+    if(v > (UINT64_MAX - d) / 10)
+      return nullptr;
+    v = v * 10 + d;
+  }
+  //the magnitude must fit T; the most negative T is one more than the
+  //largest, and an unsigned T takes no negative value but -0
+  if(neg) {
+    uint64_t most = std::is_signed<T>::value ? uint64_t(std::numeric_limits<T>::max()) + 1 : 0;
+    if(v > most)
+      return nullptr;
+    out = v == 0 ? T(0) : T(-T(v - 1) - 1);
+  }
+  else {
+    if(v > uint64_t(std::numeric_limits<T>::max()))
+      return nullptr;
+    out = T(v);
+  }
+  return p;
+}
+
+template<typename T>
+typename std::enable_if<std::is_floating_point<T>::value, const char*>::type
+parse(const char* p, const char* end, T& out) {
+  static const double pow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8,
+    1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20,
+    1e21, 1e22};
+
+  p = skip_space(p, end);
+  const char* start = p;
+  bool neg = false;
+  if(p != end && (*p == '-' || *p == '+')) {
+    neg = *p == '-';
+    ++p;
+  }
+  uint64_t mantissa = 0;
+  int digits = 0, exponent = 0;
+  bool any = false;
+  for(; p != end && unsigned(*p - '0') <= 9; ++p, any = true)
+    if(mantissa || *p != '0') {
+      mantissa = mantissa * 10 + unsigned(*p - '0');
+      ++digits;
+    }
+  if(p != end && *p == '.')
+    for(++p; p != end && unsigned(*p - '0') <= 9; ++p, any = true) {
+      if(mantissa || *p != '0') {
+        mantissa = mantissa * 10 + unsigned(*p - '0');
+        ++digits;
+      }
+      --exponent;
+    }
+  //the exponent follows the 'e' directly, so its digits are read here
+  //rather than with parse(), which would skip whitespace into the next
+  //token. It saturates well past the range of double; the slow path then
+  //gives inf or 0.
+  if(any && p != end && (*p == 'e' || *p == 'E')) {
+    ++p;
+    bool eneg = false;
+    if(p != end && (*p == '-' || *p == '+')) {
+      eneg = *p == '-';
+      ++p;
+    }
+    if(p == end || unsigned(*p - '0') > 9)
+      any = false;
+    int e = 0;
+    for(; p != end && unsigned(*p - '0') <= 9; ++p)
+      e = std::min(e * 10 + int(*p - '0'), 100000);
+    exponent += eneg ? -e : e;
+  }
+
+  if(any && (p == end || is_space(*p)) &&
+      digits <= 15 && exponent >= -22 && exponent <= 22) {
+    double v = double(mantissa);
+    v = exponent < 0 ? v / pow10[-exponent] : v * pow10[exponent];
+    out = T(neg ? -v : v);
+    return p;
+  }
+
+  //slow path: long mantissas, large exponents, inf and nan
+  p = start;
+  while(p != end && !is_space(*p))
+    ++p;
+  char buf[128];
+  size_t n = p - start;
+  if(n == 0 || n >= sizeof(buf))
+    return nullptr;
+  std::memcpy(buf, start, n);
+  buf[n] = '\0';
+  char* stop;
+  double v = std::strtod(buf, &stop);
+  if(stop != buf + n)
+    return nullptr;
+  out = T(v);
+  return p;
+}
+
+} // namespace text_parse
+
+
+///@brief Statistics of a load_text() call.
+struct text_load_stats {
+  size_t bytes;           // Size of the file
+  size_t edges;           // Edge records parsed
+  double parse_seconds;   // Mapping, splitting and parsing
+  double insert_seconds;  // Bulk insertion into the graph
+
+  text_load_stats() : bytes(0), edges(0), parse_seconds(0), insert_seconds(0) { }
+
+  double seconds() const {return parse_seconds + insert_seconds;}
+  double mb_per_second() const {return seconds() > 0 ? bytes / 1e6 / seconds() : 0;}
+  double edges_per_second() const {return seconds() > 0 ? edges / seconds() : 0;}
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Load the text format written by operator<< (a "num_vertices num_edges"
+/// line, then one vertex property per line, then one "source target
+/// property" line per edge) into g, a graph or a graph_vector, as operator>>
+/// would but in parallel:
+///
+///   1. The file is mapped read-only.
+///   2. The vertex and edge sections are each cut into a few chunks per
+///      thread, with every cut moved forward to the next line boundary.
+///   3. The threads of pool parse chunks into per-chunk batches.
+///   4. The batches are handed to insert_vertices/insert_edges in file order.
+///
+/// Properties must be arithmetic types. Returns false, leaving g untouched,
+/// if the file cannot be mapped or is malformed; otherwise g is replaced.
+/// Timings and sizes are written to stats if given.
+////////////////////////////////////////////////////////////////////////////////
+template<typename Graph>
+bool load_text(Graph& g, const std::string& path, thread_pool& pool,
+    text_load_stats* stats = nullptr) {
+  typedef typename Graph::vertex_property V;
+  typedef typename Graph::edge_property E;
+  typedef typename Graph::edge_value edge_value;
+  static_assert(std::is_arithmetic<V>::value && std::is_arithmetic<E>::value,
+      "load_text parses arithmetic properties only");
+  using namespace std::chrono;
+  high_resolution_clock::time_point start = high_resolution_clock::now();
+
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if(fd < 0)
+    return false;
+  struct stat st;
+  if(fstat(fd, &st) != 0 || st.st_size == 0) {
+    ::close(fd);
+    return false;
+  }
+  size_t size = st.st_size;
+  void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if(data == MAP_FAILED)
+    return false;
+  madvise(data, size, MADV_SEQUENTIAL);
+  const char* begin = static_cast<const char*>(data);
+  const char* end = begin + size;
+
+  //header, then find the end of the vertex section by counting lines
+  size_t num_verts = 0, num_edges = 0;
+  const char* p = text_parse::parse(begin, end, num_verts);
+  p = p ? text_parse::parse(p, end, num_edges) : nullptr;
+  const char* verts_begin = p ? std::find(p, end, '\n') : nullptr;
+  const char* edges_begin = verts_begin;
+  for(size_t i = 0; edges_begin && i < num_verts; ++i) {
+    edges_begin = text_parse::skip_space(edges_begin, end);
+    edges_begin = edges_begin == end ? nullptr : std::find(edges_begin, end, '\n');
+  }
+  if(!edges_begin) {
+    munmap(data, size);
+    return false;
+  }
+
+  //cut [first, last) into about n pieces, each ending on a line boundary
+  auto split = [](const char* first, const char* last, size_t n) {
+    std::vector<const char*> cuts(1, first);
+    for(size_t i = 1; i < n; ++i) {
+      const char* c = first + (last - first) * i / n;
+      if(c <= cuts.back())
+        continue;
+      c = std::find(c, last, '\n');
+      if(c != last && c > cuts.back())
+        cuts.push_back(c);
+    }
+    cuts.push_back(last);
+    return cuts;
+  };
+  size_t pieces = pool.size() * 4;
+  std::vector<const char*> vcuts = split(verts_begin, edges_begin, pieces);
+  std::vector<const char*> ecuts = split(edges_begin, end, pieces);
+  size_t nv = vcuts.size() - 1, ne = ecuts.size() - 1;
+
+  std::vector<std::vector<V>> vbatches(nv);
+  std::vector<std::vector<edge_value>> ebatches(ne);
+  std::vector<char> ok(nv + ne, 1);
+  pool.parallel_for(nv + ne, 1, [&](size_t, size_t b, size_t e) {
+    for(size_t c = b; c < e; ++c) {
+      if(c < nv) {
+        const char* q = vcuts[c];
+        const char* last = vcuts[c + 1];
+        std::vector<V>& out = vbatches[c];
+        for(q = text_parse::skip_space(q, last); q != last;
+            q = text_parse::skip_space(q, last)) {
+          V v;
+          q = text_parse::parse(q, last, v);
+          if(!q) {
+            ok[c] = 0;
+            break;
+          }
+          out.push_back(v);
+        }
+      }
+      else {
+        const char* q = ecuts[c - nv];
+        const char* last = ecuts[c - nv + 1];
+        std::vector<edge_value>& out = ebatches[c - nv];
+        out.reserve((last - q) / 16);
+        for(q = text_parse::skip_space(q, last); q != last;
+            q = text_parse::skip_space(q, last)) {
+          edge_value ev;
+          q = text_parse::parse(q, last, ev.first.first);
+          q = q ? text_parse::parse(q, last, ev.first.second) : nullptr;
+          q = q ? text_parse::parse(q, last, ev.second) : nullptr;
+          if(!q) {
+            ok[c] = 0;
+            break;
+          }
+          out.push_back(ev);
+        }
+      }
+    }
+  });
+  munmap(data, size);
+
+  size_t parsed_verts = 0, parsed_edges = 0;
+  for(auto& b : vbatches)
+    parsed_verts += b.size();
+  for(auto& b : ebatches)
+    parsed_edges += b.size();
+  if(std::find(ok.begin(), ok.end(), 0) != ok.end() ||
+      parsed_verts != num_verts || parsed_edges != num_edges)
+    return false;
+
+  std::vector<V> verts;
+  verts.reserve(num_verts);
+  for(auto& b : vbatches)
+    verts.insert(verts.end(), b.begin(), b.end());
+  std::vector<edge_value> edges;
+  edges.reserve(num_edges);
+  for(auto& b : ebatches) {
+    edges.insert(edges.end(), b.begin(), b.end());
+    std::vector<edge_value>().swap(b);
+  }
+  high_resolution_clock::time_point parsed = high_resolution_clock::now();
+
+  g.clear();
+  g.insert_vertices(verts.begin(), verts.end());
+  g.insert_edges(edges.begin(), edges.end());
+  high_resolution_clock::time_point inserted = high_resolution_clock::now();
+
+  if(stats) {
+    stats->bytes = size;
+    stats->edges = num_edges;
+    stats->parse_seconds = duration_cast<duration<double>>(parsed - start).count();
+    stats->insert_seconds = duration_cast<duration<double>>(inserted - parsed).count();
+  }
+  return true;
+}
+
+#endif
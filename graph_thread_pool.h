@@ -0,0 +1,118 @@
+#ifndef _GRAPH_THREAD_POOL_H_
+#define _GRAPH_THREAD_POOL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// A fixed set of worker threads for the parallel graph algorithms. The
+/// thread calling run() takes part as thread 0, so a pool of size n starts
+/// n-1 workers and a pool of size 1 runs everything inline.
+////////////////////////////////////////////////////////////////////////////////
+class thread_pool {
+
+  public:
+
+    ///@brief Start a pool of n threads. n = 0 means one per hardware thread.
+    explicit thread_pool(size_t n = 0) : m_generation(0), m_pending(0),
+      m_stop(false) {
+      if(n == 0)
+        n = std::max<size_t>(1, std::thread::hardware_concurrency());
+      for(size_t tid = 1; tid < n; ++tid)
+        m_workers.emplace_back([this, tid] { work(tid); });
+    }
+
+    ~thread_pool() {
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+      }
+      m_wake.notify_all();
+      for(auto& w : m_workers)
+        w.join();
+    }
+
+    thread_pool(const thread_pool&) = delete;             ///< Copy is disabled.
+    thread_pool& operator=(const thread_pool&) = delete;  ///< Copy is disabled.
+
+    ///@brief Number of threads, including the caller.
+    size_t size() const {return m_workers.size() + 1;}
+
+    ///@brief Call f(tid) once on every thread, tid in [0, size()), and return
+    ///       when all calls have finished.
+    template<typename F>
+    void run(F f) {
+      if(m_workers.empty()) {
+        f(size_t(0));
+        return;
+      }
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job = f;
+        m_pending = m_workers.size();
+        ++m_generation;
+      }
+      m_wake.notify_all();
+      f(size_t(0));
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_done.wait(lock, [this] {return m_pending == 0;});
+      m_job = nullptr;
+    }
+
+    ///@brief Split [0, n) into chunks of grain indices handed out dynamically
+    ///       and call f(tid, begin, end) for each chunk.
+    template<typename F>
+    void parallel_for(size_t n, size_t grain, F f) {
+      grain = std::max<size_t>(1, grain);
+      if(m_workers.empty() || n <= grain) {
+        if(n)
+          f(size_t(0), size_t(0), n);
+        return;
+      }
+      std::atomic<size_t> next(0);
+      run([&](size_t tid) {
+        for(size_t b = next.fetch_add(grain); b < n; b = next.fetch_add(grain))
+          f(tid, b, std::min(n, b + grain));
+      });
+    }
+
+  private:
+
+    void work(size_t tid) {
+      size_t seen = 0;
+      while(true) {
+        std::function<void(size_t)> job;
+        {
+          std::unique_lock<std::mutex> lock(m_mutex);
+          m_wake.wait(lock, [&] {return m_stop || m_generation != seen;});
+          if(m_stop)
+            return;
+          seen = m_generation;
+          job = m_job;
+        }
+        job(tid);
+        {
+          std::lock_guard<std::mutex> lock(m_mutex);
+          if(--m_pending == 0)
+            m_done.notify_one();
+        }
+      }
+    }
+
+    std::vector<std::thread> m_workers;     // Threads 1..size()-1
+    std::function<void(size_t)> m_job;      // Job of the current generation
+    size_t m_generation;                    // Bumped once per run()
+    size_t m_pending;                       // Workers still running the job
+    bool m_stop;                            // Set on destruction
+    std::mutex m_mutex;
+    std::condition_variable m_wake;         // Signals a new job or stop
+    std::condition_variable m_done;         // Signals the last worker finished
+};
+
+#endif
@@ -0,0 +1,657 @@
+#ifndef _GRAPH_VERSIONED_H_
+#define _GRAPH_VERSIONED_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "graph_concurrent.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// A graph whose readers work on snapshots: a snapshot sees the graph as of
+/// one committed version however long it is held, readers never lock, and
+/// writers never wait for readers.
+///
+/// Every write (insert_vertex, insert_edge, erase_edge, erase_vertex and
+/// their batch forms) is one commit and bumps the version. Writers are
+/// serialized by a mutex. The out- and in-lists of a vertex are immutable
+/// blocks, sorted by the other endpoint. A write copies the block, changes
+/// the copy and publishes it as the new head of a chain of blocks. The chain
+/// runs newest first, each block stamped with the version that made it
+/// current, so a snapshot of version V follows it to the first block stamped
+/// V or earlier. Vertices carry the versions they were inserted and erased
+/// at, and a snapshot skips those it should not see.
+///
+/// Nothing a snapshot may still reach is freed under it. A superseded block,
+/// an erased edge or an erased vertex is retired with the version that
+/// unlinked it, and only snapshots older than that version can reach it.
+/// Each snapshot pins its version in one of max_snapshots reader slots, and a
+/// retired object is freed once every pinned version is at least its tag:
+/// epoch-based reclamation with versions as the epochs. Erased vertices
+/// take two steps: once no snapshot needs them their slot is cleared, and
+/// the object is freed after the snapshots that may have loaded the slot
+/// are gone. Writers reclaim after every commit, and reclaim() frees all
+/// that can be freed.
+///
+/// Snapshots have the read interface of graph (vertex iterators,
+/// find_vertex, adjacency iterators), so breadth_first_search and the other
+/// algorithms run on them while writes go on. A snapshot must not outlive
+/// its graph.
+////////////////////////////////////////////////////////////////////////////////
+template<typename VertexProperty, typename EdgeProperty>
+class versioned_graph {
+
+  class vertex;
+  class edge;
+  struct block;
+  struct version_record;
+
+  public:
+
+    /// Unique vertex identifier
+    typedef size_t vertex_descriptor;
+
+    /// Unique edge identifier represents pair of vertex descriptors
+    typedef std::pair<size_t, size_t> edge_descriptor;
+
+    /// Property types, e.g. to build batches for insert_vertices()
+    typedef VertexProperty vertex_property;
+    typedef EdgeProperty edge_property;
+
+    /// An edge to be added by insert_edges(): its descriptor and property
+    typedef std::pair<edge_descriptor, EdgeProperty> edge_value;
+
+    /// Adjacency list iterators of a snapshot, dereferencing to edge*
+    typedef edge* const* const_adj_edge_iterator;
+    typedef const_adj_edge_iterator adj_edge_iterator;
+
+    enum : size_t {max_snapshots = 64};  ///< Snapshots held at once
+
+    class snapshot;
+
+    ///@brief Constructor/destructor. Every snapshot must be gone before the
+    ///       graph is destroyed.
+    versioned_graph() : m_current(new version_record{0, 0, 0, 0}) {
+      for(auto& r : m_readers)
+        r.version.store(idle, std::memory_order_relaxed);
+    }
+
+    ~versioned_graph() {
+      while(!m_retired.empty()) {
+        std::vector<retired> r;
+        r.swap(m_retired);
+        for(auto& x : r)
+          x.release();
+      }
+      version_record* current = m_current.load();
+      for(size_t vd = 0; vd < current->num_slots; ++vd)
+        if(vertex* v = m_vertices.get(vd)) {
+          if(block* b = v->m_out.load())
+            for(auto e : b->edges)
+              delete e;
+          delete_vertex(v);
+        }
+      delete current;
+    }
+
+    versioned_graph(const versioned_graph&) = delete;             ///< Copy is disabled.
+    versioned_graph& operator=(const versioned_graph&) = delete;  ///< Copy is disabled.
+
+    ///@brief Snapshot of the latest committed version. Waits if
+    ///       max_snapshots snapshots are held already.
+    snapshot take_snapshot() const {
+      //pin 0 first, which holds back every reclamation, so the record read
+      //below cannot be freed before the slot shows the version it has
+      size_t slot = 0;
+      for(size_t i = 0; ; i = (i + 1) % max_snapshots) {
+        size_t expected = idle;
+        if(m_readers[i].version.compare_exchange_strong(expected, 0)) {
+          slot = i;
+          break;
+        }
+        if(i + 1 == max_snapshots)
+          std::this_thread::yield();
+      }
+      version_record record = *m_current.load();
+      m_readers[slot].version.store(record.version);
+      return snapshot(this, slot, record);
+    }
+
+    ///@brief Latest committed version and its sizes
+    size_t version() const {return current().version;}
+    size_t num_vertices() const {return current().num_vertices;}
+    size_t num_edges() const {return current().num_edges;}
+
+    ///@brief Retired objects not freed yet, e.g. held back by a snapshot
+    size_t pending_reclamation() const {
+      std::lock_guard<std::mutex> lock(m_write_lock);
+      return m_retired.size();
+    }
+
+    ///@brief Modifiers, each one commit
+    vertex_descriptor insert_vertex(const VertexProperty& vp) {
+      std::lock_guard<std::mutex> lock(m_write_lock);
+      begin_write();
+      vertex_descriptor vd = add_vertex(vp);
+      commit();
+      return vd;
+    }
+
+    ///@brief Insert a range of VertexProperty values in one commit. The new
+    ///       vertices get consecutive descriptors; returns the first one.
+    template<typename InputIterator>
+    vertex_descriptor insert_vertices(InputIterator first, InputIterator last) {
+      std::lock_guard<std::mutex> lock(m_write_lock);
+      begin_write();
+      vertex_descriptor start = m_next.num_slots;
+      for(; first != last; ++first)
+        add_vertex(*first);
+      if(m_next.num_slots != start)
+        commit();
+      return start;
+    }
+
+    ///@brief Insert the edge sd->td. Returns false, committing nothing, if
+    ///       it is already in the graph or an endpoint is missing.
+    bool insert_edge(vertex_descriptor sd, vertex_descriptor td,
+        const EdgeProperty& ep) {
+      std::lock_guard<std::mutex> lock(m_write_lock);
+      begin_write();
+      if(!add_edge(sd, td, ep))
+        return false;
+      commit();
+      return true;
+    }
+
+    void insert_edge_undirected(vertex_descriptor sd, vertex_descriptor td,
+        const EdgeProperty& ep) {
+      std::lock_guard<std::mutex> lock(m_write_lock);
+      begin_write();
+      bool changed = add_edge(sd, td, ep);
+      changed = add_edge(td, sd, ep) || changed;
+      if(changed)
+        commit();
+    }
+
+    ///@brief Insert a range of edge_value in one commit, skipping those
+    ///       insert_edge() would refuse. Every touched list is copied once.
+    ///       Returns the number of edges inserted.
+    template<typename InputIterator>
+    size_t insert_edges(InputIterator first, InputIterator last) {
+      std::lock_guard<std::mutex> lock(m_write_lock);
+      begin_write();
+      size_t inserted = 0;
+      for(; first != last; ++first)
+        inserted += add_edge(first->first.first, first->first.second, first->second);
+      if(inserted)
+        commit();
+      return inserted;
+    }
+
+    ///@brief Erase the edge ed. Returns whether it was in the graph.
+    bool erase_edge(edge_descriptor ed) {
+      std::lock_guard<std::mutex> lock(m_write_lock);
+      begin_write();
+      if(!remove_edge(ed))
+        return false;
+      commit();
+      return true;
+    }
+
+    ///@brief Erase a range of edge_descriptor in one commit. Returns the
+    ///       number of edges erased.
+    template<typename InputIterator>
+    size_t erase_edges(InputIterator first, InputIterator last) {
+      std::lock_guard<std::mutex> lock(m_write_lock);
+      begin_write();
+      size_t erased = 0;
+      for(; first != last; ++first)
+        erased += remove_edge(*first);
+      if(erased)
+        commit();
+      return erased;
+    }
+
+    ///@brief Erase vertex vd and its edges in one commit. Returns whether it
+    ///       was in the graph.
+    bool erase_vertex(vertex_descriptor vd) {
+      std::lock_guard<std::mutex> lock(m_write_lock);
+      begin_write();
+      vertex* v = live_vertex(vd);
+      if(!v)
+        return false;
+      const size_t w = m_next.version;
+      //self-loops are left to the outgoing pass, which sees them too
+      if(block* in = v->m_in.load(std::memory_order_relaxed))
+        for(auto e : in->edges)
+          if(e->source() != vd) {
+            unlink(writable(m_vertices.get(e->source())->m_out), e, by_target());
+            retire_edge(e);
+          }
+      if(block* out = v->m_out.load(std::memory_order_relaxed))
+        for(auto e : out->edges) {
+          if(e->target() != vd)
+            unlink(writable(m_vertices.get(e->target())->m_in), e, by_source());
+          retire_edge(e);
+        }
+      v->m_erased.store(w, std::memory_order_release);
+      --m_next.num_vertices;
+
+      //once no snapshot older than w is left, clear the slot; snapshots that
+      //loaded it before that may still look at the vertex, so it is freed
+      //only once they are gone too
+      retire(w, [this, vd, v] {
+        m_vertices.set(vd, nullptr);
+        retire(m_current.load()->version + 1, [v] {delete_vertex(v);});
+      });
+      commit();
+      return true;
+    }
+
+    ///@brief Free every retired object no snapshot can reach. Returns the
+    ///       number freed.
+    size_t reclaim() {
+      std::lock_guard<std::mutex> lock(m_write_lock);
+      size_t freed = 0;
+      for(size_t n = reclaim_pass(); n; n = reclaim_pass())
+        freed += n;
+      return freed;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// The graph as of one version. Holds a reader slot until destroyed.
+    ////////////////////////////////////////////////////////////////////////////
+    class snapshot {
+
+      public:
+
+        typedef size_t vertex_descriptor;
+        typedef std::pair<size_t, size_t> edge_descriptor;
+        typedef VertexProperty vertex_property;
+        typedef EdgeProperty edge_property;
+        typedef versioned_graph::const_adj_edge_iterator const_adj_edge_iterator;
+        typedef versioned_graph::adj_edge_iterator adj_edge_iterator;
+
+        ////////////////////////////////////////////////////////////////////////
+        /// A vertex as of the snapshot's version, with its out- and in-lists
+        /// resolved. Stands in for vertex*: it converts from nullptr, tests
+        /// as a bool, and -> reaches its own members.
+        ////////////////////////////////////////////////////////////////////////
+        class vertex_ref {
+          public:
+            vertex_ref(std::nullptr_t = nullptr) : m_vertex(nullptr), m_out(nullptr), m_in(nullptr) { }
+            vertex_ref(const vertex* v, size_t version) : m_vertex(v),
+              m_out(resolve(v->m_out, version)), m_in(resolve(v->m_in, version)) { }
+
+            explicit operator bool() const {return m_vertex != nullptr;}
+            const vertex_ref* operator->() const {return this;}
+            bool operator==(const vertex_ref& o) const {return m_vertex == o.m_vertex;}
+            bool operator!=(const vertex_ref& o) const {return m_vertex != o.m_vertex;}
+
+            //iterators
+            const_adj_edge_iterator begin() const {return m_out ? m_out->edges.data() : nullptr;}
+            const_adj_edge_iterator cbegin() const {return begin();}
+            const_adj_edge_iterator end() const {return begin() + out_degree();}
+            const_adj_edge_iterator cend() const {return end();}
+
+            //incoming edge iterators
+            const_adj_edge_iterator in_begin() const {return m_in ? m_in->edges.data() : nullptr;}
+            const_adj_edge_iterator in_cbegin() const {return in_begin();}
+            const_adj_edge_iterator in_end() const {return in_begin() + in_degree();}
+            const_adj_edge_iterator in_cend() const {return in_end();}
+
+            //accessors
+            size_t out_degree() const {return m_out ? m_out->edges.size() : 0;}
+            size_t in_degree() const {return m_in ? m_in->edges.size() : 0;}
+            vertex_descriptor descriptor() const {return m_vertex->m_descriptor;}
+            const VertexProperty& property() const {return m_vertex->m_property;}
+
+          private:
+            ///@brief The block of the chain at head current at version
+            static const block* resolve(const std::atomic<block*>& head, size_t version) {
+              const block* b = head.load(std::memory_order_acquire);
+              while(b && b->version > version)
+                b = b->previous;
+              return b;
+            }
+
+            const vertex* m_vertex;
+            const block* m_out;  // Out-list at the version, nullptr if empty
+            const block* m_in;   // In-list at the version, nullptr if empty
+        };
+
+        ////////////////////////////////////////////////////////////////////////
+        /// Forward iterator over the vertices of the snapshot in descriptor
+        /// order, dereferencing to vertex_ref.
+        ////////////////////////////////////////////////////////////////////////
+        class const_vertex_iterator {
+          public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef vertex_ref value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const vertex_ref* pointer;
+            typedef vertex_ref reference;
+
+            const_vertex_iterator() : m_snapshot(nullptr), m_cur(0) { }
+            const_vertex_iterator(const snapshot* s, size_t cur) : m_snapshot(s), m_cur(cur) {
+              skip();
+            }
+
+            reference operator*() const {
+              return vertex_ref(m_snapshot->visible(m_cur), m_snapshot->version());
+            }
+
+            const_vertex_iterator& operator++() {
+              ++m_cur;
+              skip();
+              return *this;
+            }
+            const_vertex_iterator operator++(int) {
+              const_vertex_iterator tmp = *this;
+              ++*this;
+              return tmp;
+            }
+
+            bool operator==(const const_vertex_iterator& o) const {return m_cur == o.m_cur;}
+            bool operator!=(const const_vertex_iterator& o) const {return m_cur != o.m_cur;}
+
+          private:
+            void skip() {
+              while(m_cur < m_snapshot->m_record.num_slots && !m_snapshot->visible(m_cur))
+                ++m_cur;
+            }
+
+            const snapshot* m_snapshot;
+            size_t m_cur;  // Current descriptor
+        };
+
+        typedef const_vertex_iterator vertex_iterator;
+
+        snapshot(snapshot&& o) : m_graph(o.m_graph), m_slot(o.m_slot), m_record(o.m_record) {
+          o.m_graph = nullptr;
+        }
+
+        ~snapshot() {
+          if(m_graph)
+            m_graph->m_readers[m_slot].version.store(idle, std::memory_order_release);
+        }
+
+        snapshot(const snapshot&) = delete;             ///< Copy is disabled.
+        snapshot& operator=(const snapshot&) = delete;  ///< Copy is disabled.
+
+        ///@brief vertex iterator operations
+        const_vertex_iterator vertices_begin() const {return vertices_cbegin();}
+        const_vertex_iterator vertices_cbegin() const {return const_vertex_iterator(this, 0);}
+        const_vertex_iterator vertices_end() const {return vertices_cend();}
+        const_vertex_iterator vertices_cend() const {
+          return const_vertex_iterator(this, m_record.num_slots);
+        }
+
+        ///@brief Define accessors
+        size_t version() const {return m_record.version;}
+        size_t num_vertices() const {return m_record.num_vertices;}
+        size_t num_edges() const {return m_record.num_edges;}
+
+        const_vertex_iterator find_vertex(vertex_descriptor vd) const {
+          return visible(vd) ? const_vertex_iterator(this, vd) : vertices_cend();
+        }
+
+        ///@brief Whether the edge ed is in the snapshot, by binary search in
+        ///       the out-list of its source.
+        bool has_edge(edge_descriptor ed) const {
+          const vertex* v = visible(ed.first);
+          if(!v)
+            return false;
+          vertex_ref r(v, version());
+          auto ai = std::lower_bound(r.cbegin(), r.cend(), ed.second, by_target());
+          return ai != r.cend() && (*ai)->target() == ed.second;
+        }
+
+      private:
+        snapshot(const versioned_graph* g, size_t slot, const version_record& record) :
+          m_graph(g), m_slot(slot), m_record(record) { }
+
+        ///@brief Vertex vd if the snapshot sees it, else nullptr
+        const vertex* visible(vertex_descriptor vd) const {
+          if(vd >= m_record.num_slots)
+            return nullptr;
+          const vertex* v = m_graph->m_vertices.get(vd);
+          return v && v->m_inserted <= version() &&
+            v->m_erased.load(std::memory_order_acquire) > version() ? v : nullptr;
+        }
+
+        const versioned_graph* m_graph;  // nullptr once moved from
+        size_t m_slot;                   // Reader slot pinning the version
+        version_record m_record;         // Version and sizes seen
+        friend class versioned_graph;
+    };
+
+  private:
+    static const size_t idle = size_t(-1);  // Reader slot value when unused
+
+    ///@brief Orders a block of out-edges by target, and of in-edges by source
+    struct by_target {
+      bool operator()(const edge* e, size_t t) const {return e->target() < t;}
+      bool operator()(const edge* e, const edge* f) const {return e->target() < f->target();}
+    };
+    struct by_source {
+      bool operator()(const edge* e, size_t s) const {return e->source() < s;}
+      bool operator()(const edge* e, const edge* f) const {return e->source() < f->source();}
+    };
+
+    ///@brief An out- or in-list as of the version that made it current
+    struct block {
+      size_t version;            // Commit that published it
+      const block* previous;     // List it replaced, for older snapshots
+      std::vector<edge*> edges;  // Sorted by the other endpoint
+    };
+
+    ///@brief A committed version and the sizes of the graph at it
+    struct version_record {
+      size_t version;
+      size_t num_vertices;
+      size_t num_edges;
+      size_t num_slots;  // Descriptors handed out
+    };
+
+    ///@brief An unlinked object and how to free it once no snapshot older
+    ///       than tag is held
+    struct retired {
+      size_t tag;
+      std::function<void()> release;
+    };
+
+    ///@brief Version pinned by one snapshot, idle if none. Padded so that
+    ///       readers do not share a cache line.
+    struct reader_slot {
+      std::atomic<size_t> version;
+      char padding[64 - sizeof(std::atomic<size_t>)];
+    };
+
+    version_record current() const {
+      std::lock_guard<std::mutex> lock(m_write_lock);
+      return *m_current.load();
+    }
+
+    void begin_write() {
+      m_next = *m_current.load();
+      ++m_next.version;
+    }
+
+    ///@brief Publish m_next, then free what this made unreachable
+    void commit() {
+      version_record* old = m_current.exchange(new version_record(m_next));
+      retire(m_next.version, [old] {delete old;});
+      reclaim_pass();
+    }
+
+    void retire(size_t tag, std::function<void()> release) {
+      m_retired.push_back(retired{tag, std::move(release)});
+    }
+
+    void retire_edge(edge* e) {
+      retire(m_next.version, [e] {delete e;});
+      --m_next.num_edges;
+    }
+
+    ///@brief Free the retired objects whose tag every pinned version has
+    ///       reached. Objects retired during the pass wait for the next one,
+    ///       which scans the reader slots again. Returns the number freed.
+    size_t reclaim_pass() {
+      size_t oldest = idle;
+      for(auto& r : m_readers)
+        oldest = std::min(oldest, r.version.load());
+      size_t scanned = m_retired.size(), kept = 0, freed = 0;
+      for(size_t i = 0; i < scanned; ++i) {
+        if(m_retired[i].tag <= oldest) {
+          std::function<void()> release = std::move(m_retired[i].release);
+          release();
+          ++freed;
+        }
+        else if(kept != i)
+          m_retired[kept++] = std::move(m_retired[i]);
+        else
+          ++kept;
+      }
+      m_retired.erase(m_retired.begin() + kept, m_retired.begin() + scanned);
+      return freed;
+    }
+
+    ///@brief Vertex vd if it is in the version being written, else nullptr
+    vertex* live_vertex(vertex_descriptor vd) const {
+      if(vd >= m_next.num_slots)
+        return nullptr;
+      vertex* v = m_vertices.get(vd);
+      return v && v->m_erased.load(std::memory_order_relaxed) == idle ? v : nullptr;
+    }
+
+    ///@brief The block at head, made private to the version being written:
+    ///       the first time in a commit it is copied and the copy published
+    ///       in front of it. Snapshots older than the commit only read the
+    ///       copy's version and previous fields, so its edges can change
+    ///       until the commit.
+    block* writable(std::atomic<block*>& head) {
+      block* b = head.load(std::memory_order_relaxed);
+      if(b && b->version == m_next.version)
+        return b;
+      block* copy = b ? new block{m_next.version, b, b->edges}
+                      : new block{m_next.version, nullptr, {}};
+      head.store(copy, std::memory_order_release);
+      if(b)
+        retire(m_next.version, [b] {delete b;});
+      return copy;
+    }
+
+    template<typename Order>
+    static void link(block* b, edge* e, Order order) {
+      b->edges.insert(std::upper_bound(b->edges.begin(), b->edges.end(), e, order), e);
+    }
+
+    template<typename Order>
+    static void unlink(block* b, edge* e, Order order) {
+      auto i = std::find(std::lower_bound(b->edges.begin(), b->edges.end(), e, order),
+          b->edges.end(), e);
+      assert(i != b->edges.end());
+      b->edges.erase(i);
+    }
+
+    vertex_descriptor add_vertex(const VertexProperty& vp) {
+      vertex_descriptor vd = m_next.num_slots++;
+      m_vertices.set(vd, new vertex(vd, vp, m_next.version));
+      ++m_next.num_vertices;
+      return vd;
+    }
+
+    ///@brief Out-edge sd->td of the version being written, or nullptr
+    edge* current_edge(vertex* src_v, vertex_descriptor td) const {
+      block* b = src_v->m_out.load(std::memory_order_relaxed);
+      if(!b)
+        return nullptr;
+      auto i = std::lower_bound(b->edges.begin(), b->edges.end(), td, by_target());
+      return i != b->edges.end() && (*i)->target() == td ? *i : nullptr;
+    }
+
+    bool add_edge(vertex_descriptor sd, vertex_descriptor td, const EdgeProperty& ep) {
+      vertex* src_v = live_vertex(sd);
+      vertex* targ_v = live_vertex(td);
+      if(!src_v || !targ_v || current_edge(src_v, td))
+        return false;
+      edge* e = new edge(sd, td, ep);
+      link(writable(src_v->m_out), e, by_target());
+      link(writable(targ_v->m_in), e, by_source());
+      ++m_next.num_edges;
+      return true;
+    }
+
+    bool remove_edge(edge_descriptor ed) {
+      vertex* src_v = live_vertex(ed.first);
+      edge* e = src_v ? current_edge(src_v, ed.second) : nullptr;
+      if(!e)
+        return false;
+      unlink(writable(src_v->m_out), e, by_target());
+      unlink(writable(m_vertices.get(ed.second)->m_in), e, by_source());
+      retire_edge(e);
+      return true;
+    }
+
+    ///@brief Free a vertex and the lists it heads; older blocks of its
+    ///       chains were retired when they were replaced
+    static void delete_vertex(vertex* v) {
+      delete v->m_out.load();
+      delete v->m_in.load();
+      delete v;
+    }
+
+    mutable reader_slot m_readers[max_snapshots];  //< Version pinned by each snapshot
+    std::atomic<version_record*> m_current;        //< Latest committed version
+    concurrent_slot_map<vertex> m_vertices;        //< Every vertex not yet reclaimed
+    mutable std::mutex m_write_lock;               //< Serializes writers
+    version_record m_next;                         //< Version being written
+    std::vector<retired> m_retired;                //< Waiting for the snapshots to move on
+
+    class vertex {
+        public:
+          vertex(vertex_descriptor vd, const VertexProperty& v, size_t version) :
+            m_descriptor(vd), m_property(v), m_inserted(version), m_erased(idle),
+            m_out(nullptr), m_in(nullptr) { }
+
+        private:
+          vertex_descriptor m_descriptor; // Unique id for the vertex - assigned during insertion
+          VertexProperty m_property;      // Label or property of the vertex - passed during insertion
+          size_t m_inserted;              // Version that inserted it
+          std::atomic<size_t> m_erased;   // Version that erased it, idle while live
+          std::atomic<block*> m_out;      // Newest block of outgoing edges
+          std::atomic<block*> m_in;       // Newest block of incoming edges
+          friend class versioned_graph;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Edges represent the connections between nodes in the graph.
+    ////////////////////////////////////////////////////////////////////////////
+    class edge {
+      public:
+        edge(vertex_descriptor s, vertex_descriptor t,
+              const EdgeProperty& w) : m_source(s), m_target(t), m_property(w) { }
+
+        //accessors
+        const vertex_descriptor source() const {return m_source;}
+        const vertex_descriptor target() const {return m_target;}
+        const edge_descriptor descriptor() const {return {m_source, m_target};}
+        const EdgeProperty& property() const {return m_property;}
+
+      private:
+        vertex_descriptor m_source; // Unique id of the source vertex
+        vertex_descriptor m_target; // Unique id of the target vertex
+        EdgeProperty m_property;    // Label or weight of the edge
+    };
+};
+
+#endif
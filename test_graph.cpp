@@ -1,6 +1,24 @@
 #include "graph.h"
 #include "graph_dumb_vector.h"
+#include "graph_algorithms.h"
+#include "graph_benchmark.h"
+#include "graph_binary.h"
+#include "graph_compressed.h"
+#include "graph_concurrent.h"
+#include "graph_dynamic_bfs.h"
+#include "graph_generators.h"
+#include "graph_parallel_algorithms.h"
+#include "graph_reorder.h"
+#include "graph_text_loader.h"
+#include "graph_versioned.h"
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
 
 using namespace std;
 
@@ -40,10 +58,1111 @@ void test_graph(){
   cout << g;	
 }
 
+template<typename graphID>
+void test_csr(){
+  typedef typename graphID::vertex_descriptor VD;
+
+  graphID g;
+  for(int i = 0; i < 6; ++i)
+    g.insert_vertex(i);
+  g.insert_edge(0, 1, 0.5);
+  g.insert_edge(0, 2, 0.25);
+  g.insert_edge(1, 3, 0.75);
+  g.insert_edge(2, 3, 1.5);
+  g.insert_edge(3, 4, 2.0);
+
+  graph_csr<int, double> csr(g);
+  if(csr.num_vertices() != 6 || csr.num_edges() != 5 || csr.out_degree(0) != 2){
+	cout << "CSR build failed" << endl;
+	return;
+  }
+
+  unordered_map<VD, VD> expected, actual;
+  breadth_first_search(g, expected);
+  breadth_first_search(csr, actual);
+  if(expected != actual){
+	cout << "CSR BFS failed" << endl;
+	return;
+  }
+  depth_first_search(g, expected);
+  depth_first_search(csr, actual);
+  if(expected != actual){
+	cout << "CSR DFS failed" << endl;
+	return;
+  }
+
+  vector<VD> dense;
+  depth_first_search(g, dense);
+  for(auto& pv : expected)
+	if(dense[pv.first] != pv.second){
+	  cout << "Dense parent map failed" << endl;
+	  return;
+	}
+  cout << "CSR snapshot passed" << endl;
+}
+
+void test_simd_find(){
+  //every length around the vector widths, key at every position and absent
+  for(size_t n = 0; n < 20; ++n){
+    vector<size_t> a(n), b(n);
+    for(size_t i = 0; i < n; ++i){
+      a[i] = i * 3 + (size_t(1) << 32);
+      b[i] = i % 2;
+    }
+    for(size_t i = 0; i < n; ++i)
+      if(simd_find(a.data(), n, a[i]) != i ||
+          simd_find_pair(a.data(), b.data(), n, a[i], b[i]) != i ||
+          simd_find_pair(a.data(), b.data(), n, a[i], b[i] + 1) != n){
+	    cout << "SIMD find failed" << endl;
+	    return;
+      }
+    //same low half, different high half
+    if(simd_find(a.data(), n, 3) != n || simd_find(a.data(), n, 7) != n){
+	  cout << "SIMD find absent failed" << endl;
+	  return;
+    }
+  }
+  cout << "SIMD find (" << simd_scan_isa() << ") passed" << endl;
+}
+
+void test_benchmark_stats(){
+  sample_stats s = summarize({5, 1, 4, 2, 3});
+  sample_stats e = summarize({2, 1});
+  if(s.count != 5 || s.min != 1 || s.median != 3 || s.p95 != 5 || s.mean != 3 ||
+      e.median != 1.5 || e.p95 != 2){
+	cout << "Benchmark stats failed" << endl;
+	return;
+  }
+
+  //CSV round trip, then a 50% slowdown of one phase against it
+  vector<benchmark_record> records(2);
+  records[0].graph = records[1].graph = "set";
+  records[0].generator = records[1].generator = "mesh";
+  records[0].size = records[1].size = 400;
+  records[0].phase = "bfs";
+  records[1].phase = "dfs";
+  records[0].stats = records[1].stats = s;
+  records[0].peak_rss = 4096;
+  records[0].counters.valid[int(perf_event::page_faults)] = true;
+  records[0].counters.count[int(perf_event::page_faults)] = 7;
+  stringstream csv;
+  write_csv(csv, records);
+  vector<benchmark_record> baseline;
+  if(!read_baseline(csv, baseline) || baseline.size() != 2 ||
+      baseline[0].key() != records[0].key() || baseline[0].stats.p95 != 5 ||
+      baseline[0].peak_rss != 4096 || baseline[0].counters.count[int(perf_event::page_faults)] != 7 ||
+      baseline[0].counters.valid[int(perf_event::cycles)] || baseline[1].counters.any()){
+	cout << "Benchmark baseline failed" << endl;
+	return;
+  }
+  records[1].stats.median = 4.5;
+  stringstream report;
+  if(compare_to_baseline(records, baseline, 0.1, report) != 1 ||
+      compare_to_baseline(records, baseline, 0.6, report) != 0){
+	cout << "Benchmark comparison failed" << endl;
+	return;
+  }
+  cout << "Benchmark stats passed" << endl;
+}
+
+template<typename graphID>
+void test_bulk_insert(){
+  typedef typename graphID::edge_descriptor ED;
+  typedef typename graphID::edge_value EV;
+
+  graphID g;
+  vector<int> props = {7, 8, 9};
+  if(g.insert_vertices(props.begin(), props.end()) != 0 || g.num_vertices() != 3){
+	cout << "Bulk insert vertices failed" << endl;
+	return;
+  }
+  g.insert_edge(0, 1, 0.5);
+
+  //(0,1) already exists, (2,0) repeats, 5 is not a vertex
+  vector<EV> batch = {EV(ED(2, 0), 1.0), EV(ED(1, 2), 2.0), EV(ED(0, 1), 3.0),
+                      EV(ED(2, 0), 4.0), EV(ED(2, 5), 5.0), EV(ED(0, 2), 6.0)};
+  size_t inserted = g.insert_edges(batch.begin(), batch.end());
+  auto e = g.find_edge(ED(2, 0));
+  if(inserted != 3 || g.num_edges() != 4 || e == g.edges_end() ||
+      (*e)->property() != 1.0 || (*g.find_edge(ED(0, 1)))->property() != 0.5 ||
+      (*g.find_vertex(0))->out_degree() != 2 || (*g.find_vertex(0))->in_degree() != 1){
+	cout << "Bulk insert edges failed" << endl;
+	return;
+  }
+
+  //the stream loader goes through the same bulk path
+  stringstream ss;
+  ss << g;
+  graphID h;
+  ss >> h;
+  if(h.num_vertices() != 3 || h.num_edges() != 4 ||
+      (*h.find_vertex(2))->property() != 9 || (*h.find_vertex(2))->in_degree() != 2){
+	cout << "Bulk stream load failed" << endl;
+	return;
+  }
+  cout << "Bulk insert passed" << endl;
+}
+
+template<typename graphID>
+void test_erase(){
+  typedef typename graphID::edge_descriptor ED;
+
+  graphID g;
+  for(int i = 0; i < 4; ++i)
+    g.insert_vertex(i);
+  g.insert_edge(0, 1, 1.0);
+  g.insert_edge(1, 0, 1.0);
+  g.insert_edge(2, 1, 1.0);
+  g.insert_edge(1, 1, 1.0);
+  g.insert_edge(1, 3, 1.0);
+  g.insert_edge(2, 3, 1.0);
+  g.insert_edge(3, 0, 1.0);
+
+  //erasing 1 must take its in-edges (0,1), (2,1) and the self-loop along
+  g.erase_vertex(1);
+  if(g.num_edges() != 2 || (*g.find_vertex(0))->out_degree() != 0 ||
+      (*g.find_vertex(0))->in_degree() != 1 || (*g.find_vertex(2))->out_degree() != 1 ||
+      (*g.find_vertex(3))->in_degree() != 1){
+	cout << "Erase vertex in-edges failed" << endl;
+	return;
+  }
+
+  vector<ED> batch = {ED(3, 0), ED(0, 2), ED(2, 3)};
+  if(g.erase_edges(batch.begin(), batch.end()) != 2 || g.num_edges() != 0 ||
+      (*g.find_vertex(2))->out_degree() != 0 || (*g.find_vertex(0))->in_degree() != 0){
+	cout << "Erase edges failed" << endl;
+	return;
+  }
+  cout << "Erase passed" << endl;
+}
+
+template<typename graphID>
+void test_sorted_adjacency(){
+  typedef typename graphID::edge_descriptor ED;
+  typedef typename graphID::edge_value EV;
+
+  //mix single and bulk inserts so both keep the lists ordered
+  graphID g;
+  build_mesh(g, 8);
+  g.insert_edge(40, 2, 1.0);
+  vector<EV> batch = {EV(ED(40, 63), 1.0), EV(ED(40, 1), 1.0), EV(ED(0, 40), 1.0)};
+  g.insert_edges(batch.begin(), batch.end());
+  g.erase_vertex(33);
+  g.erase_edge(ED(40, 2));
+  for(auto vi = g.vertices_cbegin(); vi != g.vertices_cend(); ++vi){
+    const auto& v = *vi;
+    if(!is_sorted(v->cbegin(), v->cend(), [](decltype(*v->cbegin()) e, decltype(*v->cbegin()) f){
+          return e->target() < f->target();}) ||
+        !is_sorted(v->in_cbegin(), v->in_cend(), [](decltype(*v->cbegin()) e, decltype(*v->cbegin()) f){
+          return e->source() < f->source();})){
+	  cout << "Sorted adjacency order failed" << endl;
+	  return;
+    }
+    for(auto ai = v->cbegin(); ai != v->cend(); ++ai)
+      if(g.find_edge((*ai)->descriptor()) == g.edges_end() ||
+          *g.find_edge((*ai)->descriptor()) != *ai || (*ai)->target() == 33){
+	    cout << "Sorted adjacency lookup failed" << endl;
+	    return;
+      }
+    if(*g.find_vertex(v->descriptor()) != v){
+	  cout << "Sorted vertex lookup failed" << endl;
+	  return;
+    }
+  }
+  if(g.find_vertex(33) != g.vertices_end() || g.find_edge(ED(40, 2)) != g.edges_end() ||
+      g.num_vertices() != 64 || (*g.find_vertex(40))->out_degree() != 5){
+	cout << "Sorted adjacency erase failed" << endl;
+	return;
+  }
+  cout << "Sorted adjacency passed" << endl;
+}
+
+///@brief Depth of vd in the forest described by parent map p.
+template<typename ParentMap>
+size_t depth(ParentMap& p, size_t vd){
+  size_t d = 0;
+  for(; p[vd] != size_t(-1); vd = p[vd])
+	++d;
+  return d;
+}
+
+///@brief Build an undirected rootn x rootn mesh plus one isolated vertex.
+template<typename graphID>
+void build_mesh(graphID& g, size_t rootn){
+  size_t n = rootn * rootn;
+  for(size_t i = 0; i <= n; ++i)
+    g.insert_vertex(i);
+  for(size_t i = 0; i < n; ++i) {
+    if((i + 1) % rootn != 0)
+      g.insert_edge_undirected(i, i + 1, 1.0);
+    if(i + rootn < n)
+      g.insert_edge_undirected(i, i + rootn, 1.0);
+  }
+}
+
+template<typename graphID>
+void test_compressed(){
+  typedef typename graphID::vertex_descriptor VD;
+  typedef typename graphID::edge_descriptor ED;
+
+  //long and backward edges need multi-byte and negative first entries
+  graphID g;
+  build_mesh(g, 20);
+  g.insert_edge(399, 0, 2.5);
+  g.insert_edge(0, 399, 3.5);
+  g.insert_edge(250, 3, 4.5);
+  //a hub whose list spans several decode blocks: a long run of one-byte
+  //gaps, then a two-byte one
+  for(VD t = 1; t <= 150; ++t)
+    if(g.find_edge(ED(399, t)) == g.edges_end())
+      g.insert_edge(399, t, 1.0);
+  g.insert_edge(399, 300, 1.0);
+  g.erase_vertex(5);
+
+  graph_compressed<int, double> c(g);
+  if(c.num_vertices() != g.num_vertices() || c.num_edges() != g.num_edges() ||
+      c.contains(5) || c.adjacency_bytes_per_edge() > 2.0){
+	cout << "Compressed build failed" << endl;
+	return;
+  }
+  for(auto vi = c.vertices_cbegin(); vi != c.vertices_cend(); ++vi){
+    auto w = c.weights_begin(*vi);
+    size_t degree = 0;
+    VD prev = 0;
+    for(auto ai = c.out_begin(*vi); ai != c.out_end(*vi); ++ai, ++w, ++degree){
+      auto e = g.find_edge(ED(*vi, *ai));
+      if(e == g.edges_end() || (*e)->property() != *w || (degree && *ai <= prev)){
+	    cout << "Compressed adjacency failed" << endl;
+	    return;
+      }
+      prev = *ai;
+    }
+    if(degree != c.out_degree(*vi) || degree != (*g.find_vertex(*vi))->out_degree()){
+	  cout << "Compressed degree failed" << endl;
+	  return;
+    }
+    //the block decoder gives the same list as the iterator
+    vector<VD> iterated(c.out_begin(*vi), c.out_end(*vi)), blocks;
+    c.for_each_target(*vi, [&](VD t){blocks.push_back(t);});
+    if(iterated != blocks){
+	  cout << "Compressed block decode failed" << endl;
+	  return;
+    }
+  }
+
+  //adjacency order differs from the source graph, BFS depths do not
+  vector<VD> expected, actual;
+  breadth_first_search(g, expected);
+  breadth_first_search(c, actual);
+  for(auto vi = c.vertices_cbegin(); vi != c.vertices_cend(); ++vi)
+    if(depth(expected, *vi) != depth(actual, *vi)){
+	  cout << "Compressed BFS failed" << endl;
+	  return;
+    }
+  cout << "Compressed adjacency passed" << endl;
+}
+
+template<typename graphID>
+void test_binary(){
+  typedef typename graphID::vertex_descriptor VD;
+  const char* path = "test_graph.bin";
+
+  //a hole at descriptor 7 checks that descriptors survive the round trip
+  graphID g;
+  build_mesh(g, 10);
+  g.erase_vertex(7);
+  if(!save_binary(g, path)){
+	cout << "Binary save failed" << endl;
+	return;
+  }
+
+  vector<VD> expected, actual;
+  breadth_first_search(g, expected);
+  {
+    graph_mapped<int, double> m(path);
+    breadth_first_search(m, actual);
+    if(!m.is_open() || m.num_vertices() != g.num_vertices() ||
+        m.num_edges() != g.num_edges() || m.contains(7) || expected != actual){
+	  cout << "Binary mapped BFS failed" << endl;
+	  return;
+    }
+  }
+
+  graphID h;
+  actual.clear();
+  if(!load_binary(h, path) || h.num_edges() != g.num_edges() ||
+      h.find_vertex(7) != h.vertices_end() || (*h.find_vertex(42))->property() != 42){
+	cout << "Binary load failed" << endl;
+	return;
+  }
+  breadth_first_search(h, actual);
+  if(expected != actual){
+	cout << "Binary load BFS failed" << endl;
+	return;
+  }
+
+  //a file of another version is rejected
+  {
+    fstream f(path, ios::in | ios::out | ios::binary);
+    f.seekp(8);
+    uint32_t version = graph_binary_version + 1;
+    f.write(reinterpret_cast<const char*>(&version), sizeof(version));
+  }
+  graph_mapped<int, double> stale;
+  if(stale.open(path) || load_binary(h, path) || h.num_edges() != g.num_edges()){
+	cout << "Binary version check failed" << endl;
+	return;
+  }
+
+  //overwrite one 64-bit word of a freshly saved file
+  auto corrupt = [&](size_t at, uint64_t value){
+    save_binary(g, path);
+    fstream f(path, ios::in | ios::out | ios::binary);
+    f.seekp(at);
+    f.write(reinterpret_cast<const char*>(&value), sizeof(value));
+  };
+  graph_binary_header header;
+  save_binary(g, path);
+  {
+    ifstream f(path, ios::binary);
+    f.read(reinterpret_cast<char*>(&header), sizeof(header));
+  }
+  graph_binary_layout layout(header);
+
+  //an adjacency range far past the targets, a target that was erased, and
+  //a descriptor out of order
+  vector<pair<size_t, uint64_t>> bad_arrays = {
+    {layout.offsets + 8, uint64_t(1) << 40},
+    {layout.targets, 7},
+    {layout.descriptors, 99}};
+  for(auto& bad : bad_arrays){
+    corrupt(bad.first, bad.second);
+    graph_mapped<int, double> corrupted;
+    if(corrupted.open(path) || corrupted.num_edges() != 0 || load_binary(h, path)){
+	  cout << "Binary corrupted arrays check failed" << endl;
+	  return;
+    }
+  }
+
+  //edge counts whose array sizes wrap around to a size that fits the file
+  graph_binary_header huge = header;
+  huge.num_edges = uint64_t(1) << 61;
+  corrupt(offsetof(graph_binary_header, num_edges), huge.num_edges);
+  graph_mapped<int, double> wrapped;
+  if(graph_binary_layout(huge).valid || wrapped.open(path) ||
+      load_binary(h, path)){
+	cout << "Binary wrapped header check failed" << endl;
+	return;
+  }
+  remove(path);
+  cout << "Binary format passed" << endl;
+}
+
+template<typename graphID>
+void test_text_loader(){
+  typedef typename graphID::edge_descriptor ED;
+  const char* path = "test_graph.txt";
+
+  //random weights exercise the floating point parser against operator>>
+  graphID g;
+  build_mesh(g, 20);
+  for(auto ei = g.edges_begin(); ei != g.edges_end(); ++ei)
+    (*ei)->property() = double(rand()) / RAND_MAX * (rand() % 2 ? 1e-3 : 1e3);
+  {
+    ofstream os(path);
+    os << g;
+    os << 5 << " " << 3 << " " << 1.0 << endl;
+  }
+
+  graphID expected, actual;
+  {
+    ifstream is(path);
+    is >> expected;
+  }
+  //the extra line makes the file one edge longer than its header says
+  thread_pool pool(3);
+  if(load_text(actual, path, pool)){
+	cout << "Text loader length check failed" << endl;
+	return;
+  }
+  {
+    ofstream os(path);
+    os << g;
+  }
+  text_load_stats stats;
+  if(!load_text(actual, path, pool, &stats) || stats.edges != g.num_edges() ||
+      actual.num_vertices() != expected.num_vertices() ||
+      actual.num_edges() != expected.num_edges()){
+	cout << "Text loader failed" << endl;
+	return;
+  }
+  for(auto ei = expected.edges_cbegin(); ei != expected.edges_cend(); ++ei){
+    auto ai = actual.find_edge(ED((*ei)->source(), (*ei)->target()));
+    if(ai == actual.edges_end() || (*ai)->property() != (*ei)->property()){
+	  cout << "Text loader parse failed" << endl;
+	  return;
+    }
+  }
+
+  //a weight cut short at "1e" must not take its exponent from the next
+  //line, which would leave a well-formed but shifted second edge
+  {
+    ofstream os(path);
+    os << "2 2\n0\n1\n0 1 1e\n1 1 0 2\n";
+  }
+  if(load_text(actual, path, pool) || actual.num_edges() != expected.num_edges()){
+	cout << "Text loader exponent check failed" << endl;
+	return;
+  }
+
+  //tokens that overflow their type are rejected rather than wrapped
+  auto parses = [](const string& token, auto value){
+    return text_parse::parse(token.data(), token.data() + token.size(), value) != nullptr;
+  };
+  uint8_t u8 = 0;
+  int8_t i8 = 0;
+  size_t sz = 0;
+  double d = 0;
+  string huge = "1e4294967297";
+  const char* huge_end = text_parse::parse(huge.data(), huge.data() + huge.size(), d);
+  if(parses("18446744073709551616", sz) || parses("99999999999999999999", sz) ||
+      parses("256", u8) || parses("-1", u8) || parses("-129", i8) || parses("128", i8) ||
+      parses("-1", sz) || !parses("18446744073709551615", sz) ||
+      !huge_end || !std::isinf(d)){
+	cout << "Text loader overflow check failed" << endl;
+	return;
+  }
+  string lowest = "-128";
+  text_parse::parse(lowest.data(), lowest.data() + lowest.size(), i8);
+  if(i8 != -128){
+	cout << "Text loader overflow check failed" << endl;
+	return;
+  }
+  remove(path);
+  cout << "Text loader passed" << endl;
+}
+
+template<typename graphID>
+void test_memory_usage(){
+  typedef typename graphID::edge_descriptor ED;
+
+  graphID g;
+  graph_memory_usage empty = g.memory_usage();
+  if(empty.vertex_bytes() != 0 || empty.edge_bytes() != 0){
+	cout << "Memory usage empty failed" << endl;
+	return;
+  }
+
+  build_mesh(g, 10);
+  graph_memory_usage u = g.memory_usage();
+  if(u.vertex_objects != 101 * sizeof(**g.vertices_cbegin()) ||
+      u.edge_objects != g.num_edges() * sizeof(**g.edges_cbegin()) ||
+      u.vertex_index < 101 * sizeof(void*) || u.edge_index < g.num_edges() * sizeof(void*) ||
+      u.adjacency < 2 * g.num_edges() * sizeof(void*) ||
+      u.total() != u.vertex_bytes() + u.edge_bytes() + u.arena_overhead ||
+      u.bytes_per_edge(g.num_edges()) <= 0){
+	cout << "Memory usage failed" << endl;
+	return;
+  }
+
+  //erasing hands the bytes back to the same counters, so none wraps around
+  vector<ED> eds;
+  for(auto ei = g.edges_cbegin(); ei != g.edges_cend(); ++ei)
+    eds.push_back((*ei)->descriptor());
+  g.erase_edges(eds.begin(), eds.begin() + eds.size() / 2);
+  for(size_t vd = 0; vd < 101; vd += 3)
+    g.erase_vertex(vd);
+  graph_memory_usage after = g.memory_usage();
+  if(after.vertex_objects >= u.vertex_objects || after.edge_objects >= u.edge_objects ||
+      after.total() > u.total() + u.total() / 2){
+	cout << "Memory usage after erase failed" << endl;
+	return;
+  }
+  cout << "Memory usage passed" << endl;
+}
+
+template<typename graphID>
+void test_reorder(){
+  typedef typename graphID::edge_descriptor ED;
+
+  //a 12 x 12 mesh under scrambled labels has a large bandwidth
+  graphID mesh, g;
+  build_mesh(mesh, 12);
+  vector<size_t> scramble;
+  for(size_t i = 0; i <= 144; ++i)
+    scramble.push_back(i * 97 % 145);
+  vertex_relabeling scrambled;
+  relabel(mesh, scramble, g, scrambled);
+
+  auto bandwidth = [](const graphID& h) {
+    size_t b = 0;
+    for(auto ei = h.edges_cbegin(); ei != h.edges_cend(); ++ei)
+      b = max(b, (*ei)->source() > (*ei)->target() ? (*ei)->source() - (*ei)->target()
+                                                   : (*ei)->target() - (*ei)->source());
+    return b;
+  };
+
+  for(auto order : {vertex_order::reverse_cuthill_mckee, vertex_order::degree_descending,
+                    vertex_order::bfs}){
+    graphID r;
+    vertex_relabeling map;
+    reorder(g, order, r, map);
+    if(r.num_vertices() != g.num_vertices() || r.num_edges() != g.num_edges() ||
+        map.new_to_old.size() != g.num_vertices()){
+	  cout << "Reorder failed" << endl;
+	  return;
+    }
+    for(auto ei = g.edges_cbegin(); ei != g.edges_cend(); ++ei){
+      ED ed(map.old_to_new[(*ei)->source()], map.old_to_new[(*ei)->target()]);
+      if(map.new_to_old[ed.first] != (*ei)->source() || r.find_edge(ed) == r.edges_end()){
+	    cout << "Reorder mapping failed" << endl;
+	    return;
+      }
+    }
+    if(order == vertex_order::reverse_cuthill_mckee && bandwidth(r) > 2 * 12){
+	  cout << "Reorder RCM bandwidth failed" << endl;
+	  return;
+    }
+    if(order == vertex_order::degree_descending)
+      for(size_t i = 1; i < r.num_vertices(); ++i)
+        if((*r.find_vertex(i))->out_degree() > (*r.find_vertex(i - 1))->out_degree()){
+	      cout << "Reorder degree failed" << endl;
+	      return;
+        }
+  }
+  if(bandwidth(g) <= 2 * 12){
+	cout << "Reorder scramble failed" << endl;
+	return;
+  }
+  cout << "Reorder passed" << endl;
+}
+
+template<typename graphID>
+void test_generators(){
+  typedef typename graphID::edge_value EV;
+
+  //a batch must not depend on the number of threads emitting it
+  thread_pool pool(4);
+  vector<EV> serial, parallel, other_seed;
+  rmat_edges(serial, 12, 3 * generator_grain + 17, 7);
+  rmat_edges(parallel, 12, 3 * generator_grain + 17, 7, &pool);
+  rmat_edges(other_seed, 12, 3 * generator_grain + 17, 8, &pool);
+  if(serial != parallel || serial == other_seed || serial.size() != 3 * generator_grain + 17){
+	cout << "Generators R-MAT determinism failed" << endl;
+	return;
+  }
+  //hubs: the most frequent source has far more than the average 48 edges
+  vector<size_t> degree(4096, 0);
+  for(auto& e : serial){
+    if(e.first.first >= 4096 || e.first.second >= 4096){
+	  cout << "Generators R-MAT range failed" << endl;
+	  return;
+    }
+    ++degree[e.first.first];
+  }
+  if(*max_element(degree.begin(), degree.end()) < 10 * 48){
+	cout << "Generators R-MAT skew failed" << endl;
+	return;
+  }
+
+  serial.clear();
+  parallel.clear();
+  gnp_edges(serial, 3000, 0.01, 3);
+  gnp_edges(parallel, 3000, 0.01, 3, &pool);
+  double expected = 0.01 * 3000 * 2999;
+  if(serial != parallel || fabs(serial.size() - expected) > 0.05 * expected){
+	cout << "Generators G(n,p) failed" << endl;
+	return;
+  }
+  for(size_t i = 0; i < serial.size(); ++i)
+    if(serial[i].first.first == serial[i].first.second ||
+        (i > 0 && !(serial[i - 1].first < serial[i].first))){
+	  cout << "Generators G(n,p) pairs failed" << endl;
+	  return;
+    }
+  serial.clear();
+  gnp_edges(serial, 50, 1.0, 3);
+  if(serial.size() != 50 * 49){
+	cout << "Generators G(n,p) p = 1 failed" << endl;
+	return;
+  }
+
+  serial.clear();
+  parallel.clear();
+  mesh_edges(serial, 300, 5);
+  mesh_edges(parallel, 300, 5, &pool);
+  graphID g;
+  insert_generated(g, 300 * 300, parallel);
+  if(serial != parallel || g.num_vertices() != 300 * 300 || g.num_edges() != 4 * 300 * 299){
+	cout << "Generators mesh failed" << endl;
+	return;
+  }
+
+  graph_rng rng(1);
+  for(int i = 0; i < 1000; ++i)
+    if(rng.below(7) >= 7 || rng.uniform() >= 1.0){
+	  cout << "Generators rng failed" << endl;
+	  return;
+    }
+  cout << "Generators passed" << endl;
+}
+
+void test_concurrent_graph(){
+  typedef concurrent_graph<int, double> CG;
+  typedef graph<int, double> G;
+  typedef G::edge_descriptor ED;
+  typedef G::edge_value EV;
+
+  //vertices from four threads get distinct descriptors 0..999
+  CG g(8);
+  thread_pool pool(4);
+  pool.run([&](size_t tid){
+    for(int i = 0; i < 250; ++i)
+      g.insert_vertex(int(tid));
+  });
+  if(g.num_vertices() != 1000 || g.find_vertex(999) == g.vertices_cend() ||
+      g.find_vertex(1000) != g.vertices_cend()){
+	cout << "Concurrent graph vertices failed" << endl;
+	return;
+  }
+
+  //every thread inserts the whole batch, so each edge is raced for
+  vector<EV> batch;
+  rmat_edges(batch, 10, 20000, 1);
+  G ref;
+  insert_generated(ref, 1000, batch);
+  pool.run([&](size_t){
+    g.insert_edges(batch.begin(), batch.end());
+  });
+  if(g.num_edges() != ref.num_edges()){
+	cout << "Concurrent graph insert failed" << endl;
+	return;
+  }
+
+  //erase every other edge and one vertex while the threads race again
+  vector<ED> erased;
+  for(auto ei = ref.edges_cbegin(); ei != ref.edges_cend(); ++ei)
+    if(((*ei)->source() + (*ei)->target()) % 2)
+      erased.push_back((*ei)->descriptor());
+  pool.run([&](size_t tid){
+    if(tid == 1)
+      g.erase_vertex(7);
+    for(size_t i = tid; i < erased.size(); i += pool.size())
+      g.erase_edge(erased[i]);
+  });
+  ref.erase_edges(erased.begin(), erased.end());
+  ref.erase_vertex(7);
+
+  double w;
+  if(g.num_edges() != ref.num_edges() || g.num_vertices() != ref.num_vertices() ||
+      g.has_edge(erased[0]) || g.find_edge_property(erased[0], w)){
+	cout << "Concurrent graph erase failed" << endl;
+	return;
+  }
+  for(auto ei = ref.edges_cbegin(); ei != ref.edges_cend(); ++ei)
+    if(!g.find_edge_property((*ei)->descriptor(), w) || w != (*ei)->property()){
+	  cout << "Concurrent graph edges failed" << endl;
+	  return;
+    }
+  for(auto vi = ref.vertices_cbegin(); vi != ref.vertices_cend(); ++vi){
+    auto v = *g.find_vertex((*vi)->descriptor());
+    if(v->out_degree() != (*vi)->out_degree() || v->in_degree() != (*vi)->in_degree()){
+	  cout << "Concurrent graph degrees failed" << endl;
+	  return;
+    }
+  }
+
+  //the algorithms run on it once the writers are done: same BFS roots, and
+  //every tree edge is an edge
+  vector<size_t> p, q;
+  breadth_first_search(g, p);
+  breadth_first_search(ref, q);
+  for(size_t vd = 0; vd < q.size(); ++vd)
+    if((p[vd] == size_t(-1)) != (q[vd] == size_t(-1)) ||
+        (p[vd] != size_t(-1) && !g.has_edge(ED(p[vd], vd)))){
+	  cout << "Concurrent graph BFS failed" << endl;
+	  return;
+    }
+
+  g.clear();
+  if(g.num_vertices() != 0 || g.num_edges() != 0 || g.vertices_cbegin() != g.vertices_cend()){
+	cout << "Concurrent graph clear failed" << endl;
+	return;
+  }
+  cout << "Concurrent graph passed" << endl;
+}
+
+void test_versioned_graph(){
+  typedef versioned_graph<int, double> VG;
+  typedef graph<int, double> G;
+  typedef G::edge_descriptor ED;
+  typedef G::edge_value EV;
+
+  //a snapshot whose sizes and adjacency lists agree with each other, and
+  //whose BFS tree only uses its own edges
+  auto consistent = [](const VG::snapshot& s){
+    size_t vertices = 0, out = 0, in = 0;
+    for(auto vi = s.vertices_cbegin(); vi != s.vertices_cend(); ++vi){
+      ++vertices;
+      out += (*vi)->out_degree();
+      in += (*vi)->in_degree();
+    }
+    vector<size_t> p;
+    breadth_first_search(s, p);
+    for(size_t vd = 0; vd < p.size(); ++vd)
+      if(p[vd] != size_t(-1) && !s.has_edge(ED(p[vd], vd)))
+        return false;
+    return vertices == s.num_vertices() && out == s.num_edges() && in == s.num_edges();
+  };
+  //s holds exactly the edges of ref
+  auto same_edges = [](const VG::snapshot& s, const G& ref){
+    if(s.num_edges() != ref.num_edges() || s.num_vertices() != ref.num_vertices())
+      return false;
+    for(auto ei = ref.edges_cbegin(); ei != ref.edges_cend(); ++ei)
+      if(!s.has_edge((*ei)->descriptor()))
+        return false;
+    return true;
+  };
+
+  vector<EV> batch;
+  mesh_edges(batch, 12, 2);
+  VG g;
+  G ref;
+  vector<int> props(144, 0);
+  g.insert_vertices(props.begin(), props.end());
+  g.insert_edges(batch.begin(), batch.end());
+  insert_generated(ref, 144, batch);
+  {
+    VG::snapshot before = g.take_snapshot();
+    vector<ED> erased;
+    for(size_t i = 0; i < batch.size(); i += 3)
+      erased.push_back(batch[i].first);
+    g.erase_edges(erased.begin(), erased.end());
+    g.erase_vertex(13);
+    g.insert_edge(0, 143, 1.0);
+    if(!same_edges(before, ref) || !consistent(before) || g.pending_reclamation() == 0 ||
+        before.find_vertex(13) == before.vertices_cend()){
+	  cout << "Versioned graph snapshot isolation failed" << endl;
+	  return;
+    }
+    ref.erase_edges(erased.begin(), erased.end());
+    ref.erase_vertex(13);
+    ref.insert_edge(0, 143, 1.0);
+    VG::snapshot after = g.take_snapshot();
+    if(!same_edges(after, ref) || !consistent(after) ||
+        after.find_vertex(13) != after.vertices_cend() || after.version() <= before.version()){
+	  cout << "Versioned graph update failed" << endl;
+	  return;
+    }
+  }
+  g.reclaim();
+  if(g.pending_reclamation() != 0){
+	cout << "Versioned graph reclamation failed" << endl;
+	return;
+  }
+
+  //readers take snapshots and search them while a writer keeps changing
+  //the graph
+  thread_pool pool(4);
+  atomic<bool> writing(true), failed(false);
+  pool.run([&](size_t tid){
+    if(tid == 0){
+      graph_rng rng(5);
+      for(int i = 0; i < 3000; ++i){
+        size_t s = rng.below(144), t = rng.below(144);
+        if(i % 500 == 499){
+          g.erase_vertex(s);
+          g.insert_vertex(i);
+        }
+        else if(rng.below(2))
+          g.insert_edge_undirected(s, t, 1.0);
+        else
+          g.erase_edge(ED(s, t));
+      }
+      writing = false;
+      return;
+    }
+    while(writing)
+      if(!consistent(g.take_snapshot()))
+        failed = true;
+  });
+  g.reclaim();
+  if(failed || !consistent(g.take_snapshot()) || g.pending_reclamation() != 0){
+	cout << "Versioned graph concurrent readers failed" << endl;
+	return;
+  }
+  cout << "Versioned graph passed" << endl;
+}
+
+template<typename graphID>
+void test_direction_optimizing_bfs(){
+  typedef typename graphID::vertex_descriptor VD;
+
+  graphID g;
+  build_mesh(g, 5);
+
+  unordered_map<VD, VD> expected, actual;
+  breadth_first_search(g, expected);
+
+  //huge alpha forces bottom-up right away, huge beta keeps it there
+  bfs_direction_params params;
+  params.alpha = 1e9;
+  params.beta = 1e9;
+  vector<bfs_level_trace> trace;
+  direction_optimizing_bfs(g, actual, params, &trace);
+  if(actual.size() != expected.size() || trace.empty() ||
+      trace.front().direction != bfs_direction::bottom_up){
+	cout << "Direction-optimizing BFS failed" << endl;
+	return;
+  }
+  for(auto& pv : expected)
+	if(depth(actual, pv.first) != depth(expected, pv.first)){
+	  cout << "Direction-optimizing BFS depth failed" << endl;
+	  return;
+	}
+  cout << "Direction-optimizing BFS passed" << endl;
+}
+
+template<typename graphID>
+void test_parallel_bfs(){
+  typedef typename graphID::vertex_descriptor VD;
+
+  graphID g;
+  build_mesh(g, 30);
+
+  unordered_map<VD, VD> expected;
+  vector<VD> actual;
+  breadth_first_search(g, expected);
+  thread_pool pool(4);
+  parallel_breadth_first_search(g, actual, pool, 1);
+  for(auto& pv : expected)
+	if(depth(actual, pv.first) != depth(expected, pv.first)){
+	  cout << "Parallel BFS failed" << endl;
+	  return;
+	}
+  cout << "Parallel BFS passed" << endl;
+}
+
+template<typename graphID>
+void test_multi_source_bfs(){
+  typedef typename graphID::vertex_descriptor VD;
+
+  //70 sources, so two batches
+  graphID g;
+  build_mesh(g, 10);
+  vector<VD> sources;
+  for(VD s = 0; s < 70; ++s)
+    sources.push_back(s);
+
+  vector<vector<size_t>> dist;
+  vector<vector<VD>> parent;
+  multi_source_bfs(g, sources, dist, parent);
+
+  for(size_t i = 0; i < sources.size(); ++i) {
+    for(size_t vd = 0; vd < 100; ++vd) {
+      size_t x = sources[i] % 10, y = sources[i] / 10;
+      size_t manhattan = (x > vd % 10 ? x - vd % 10 : vd % 10 - x) +
+                         (y > vd / 10 ? y - vd / 10 : vd / 10 - y);
+      if(dist[i][vd] != manhattan ||
+          (vd != sources[i] && dist[i][parent[i][vd]] + 1 != dist[i][vd])){
+        cout << "Multi-source BFS failed" << endl;
+        return;
+      }
+    }
+    //the isolated vertex is unreachable
+    if(dist[i][100] != size_t(-1)){
+      cout << "Multi-source BFS failed" << endl;
+      return;
+    }
+  }
+  cout << "Multi-source BFS passed" << endl;
+}
+
+template<typename graphID>
+void test_dynamic_bfs(){
+  typedef typename graphID::vertex_descriptor VD;
+  typedef typename graphID::edge_descriptor ED;
+
+  //a sparse random graph, so erasures cut off whole subtrees
+  graphID g;
+  graph_rng rng(11);
+  vector<VD> live;
+  for(int i = 0; i < 300; ++i)
+    live.push_back(g.insert_vertex(i));
+  for(int i = 0; i < 600; ++i){
+    VD s = live[rng.below(300)], t = live[rng.below(300)];
+    if(g.find_edge(ED(s, t)) == g.edges_end())
+      g.insert_edge(s, t, 1.0);
+  }
+  dynamic_bfs<graphID> bfs(g, live[0]);
+
+  vector<vector<size_t>> dist;
+  vector<vector<VD>> parent;
+  for(int step = 0; step < 3000; ++step){
+    size_t op = rng.below(20);
+    if(op < 9){
+      VD s = live[rng.below(live.size())], t = live[rng.below(live.size())];
+      if(g.find_edge(ED(s, t)) == g.edges_end())
+        bfs.insert_edge(s, t, 1.0);
+    }
+    else if(op < 17){
+      //mostly tree edges, the ones that need repair
+      VD t = live[rng.below(live.size())];
+      if(bfs.parent(t) != VD(-1))
+        bfs.erase_edge(ED(bfs.parent(t), t));
+      else if(op == 16 && (*g.find_vertex(t))->cbegin() != (*g.find_vertex(t))->cend())
+        bfs.erase_edge(ED(t, (*(*g.find_vertex(t))->cbegin())->target()));
+    }
+    else if(op == 17 && live.size() > 2){
+      size_t i = 1 + rng.below(live.size() - 1);
+      bfs.erase_vertex(live[i]);
+      live.erase(live.begin() + i);
+    }
+    else if(op == 18)
+      live.push_back(bfs.insert_vertex(step));
+    else{
+      //changed behind its back, then reported
+      VD s = live[rng.below(live.size())], t = live[rng.below(live.size())];
+      if(g.find_edge(ED(s, t)) == g.edges_end()){
+        g.insert_edge(s, t, 1.0);
+        bfs.edge_inserted(s, t);
+      }
+    }
+
+    multi_source_bfs(g, vector<VD>(1, live[0]), dist, parent);
+    for(VD vd : live){
+      VD p = bfs.parent(vd);
+      if(bfs.distance(vd) != (vd < dist[0].size() ? dist[0][vd] : size_t(-1)) ||
+          (vd != live[0] && bfs.distance(vd) != size_t(-1) &&
+           (g.find_edge(ED(p, vd)) == g.edges_end() || bfs.distance(p) + 1 != bfs.distance(vd)))){
+        cout << "Dynamic BFS failed" << endl;
+        return;
+      }
+    }
+  }
+
+  //erasing the root leaves nothing reachable
+  bfs.erase_vertex(live[0]);
+  for(VD vd : live)
+    if(bfs.distance(vd) != size_t(-1) || bfs.parent(vd) != VD(-1)){
+      cout << "Dynamic BFS root failed" << endl;
+      return;
+    }
+  cout << "Dynamic BFS passed" << endl;
+}
+
+template<typename graphID>
+void test_shortest_paths(){
+  typedef typename graphID::vertex_descriptor VD;
+  typedef typename graphID::edge_descriptor ED;
+
+  //a ring of 200 vertices with chords, deterministic weights in (0, 1]
+  graphID g;
+  size_t n = 200, seed = 1;
+  for(size_t i = 0; i < n; ++i)
+    g.insert_vertex(i);
+  for(size_t i = 0; i < n; ++i) {
+    seed = (seed * 1103515245 + 12345) % 2147483648;
+    g.insert_edge_undirected(i, (i + 1) % n, (seed % 100 + 1) / 100.0);
+    if(i % 3 == 0)
+      g.insert_edge(i, (i * 7 + 11) % n, (seed % 37 + 1) / 37.0);
+  }
+
+  unordered_map<VD, VD> parent;
+  unordered_map<VD, double> expected;
+  vector<VD> ds_parent;
+  vector<double> actual;
+  dijkstra_shortest_paths(g, 5, parent, expected);
+  thread_pool pool(4);
+  delta_stepping_shortest_paths(g, 5, ds_parent, actual, 0.1, pool);
+
+  for(auto& pv : parent) {
+    VD vd = pv.first;
+    if(abs(expected[vd] - actual[vd]) > 1e-9){
+	  cout << "Shortest paths distance failed" << endl;
+	  return;
+	}
+    if(vd == 5 ? (pv.second != VD(-1) || ds_parent[vd] != VD(-1)) :
+        abs(expected[pv.second] + (*g.find_edge(ED(pv.second, vd)))->property() -
+          expected[vd]) > 1e-9 ||
+        abs(actual[ds_parent[vd]] + (*g.find_edge(ED(ds_parent[vd], vd)))->property() -
+          actual[vd]) > 1e-9){
+	  cout << "Shortest paths parent failed" << endl;
+	  return;
+	}
+  }
+  cout << "Shortest paths passed" << endl;
+}
+
+template<typename graphID>
+void test_connected_components(){
+  typedef typename graphID::vertex_descriptor VD;
+
+  //one mesh, the isolated vertex 900, and a directed chain 903 -> 902 -> 901
+  graphID g;
+  build_mesh(g, 30);
+  for(int i = 0; i < 3; ++i)
+    g.insert_vertex(i);
+  g.insert_edge(903, 902, 1.0);
+  g.insert_edge(902, 901, 1.0);
+
+  vector<VD> comp;
+  thread_pool pool(4);
+  size_t count = connected_components(g, comp, pool);
+  if(count != 3 || comp[899] != 0 || comp[900] != 900 || comp[903] != 901){
+	cout << "Connected components failed" << endl;
+	return;
+  }
+  cout << "Connected components passed" << endl;
+}
+
 int main() {
   typedef graph<int, double> setGraph;
+  typedef graph<int, double, heap_arena> heapGraph;
   typedef graph_vector<int, double> vectorGraph;
+  typedef graph_vector<int, double, vector_soa> soaVectorGraph;
+  typedef graph_vector<int, double, vector_sorted> sortedVectorGraph;
   
   test_graph<vectorGraph>();
   test_graph<setGraph>();
+  test_graph<heapGraph>();
+  test_graph<soaVectorGraph>();
+  test_graph<sortedVectorGraph>();
+  test_simd_find();
+  test_benchmark_stats();
+  test_bulk_insert<vectorGraph>();
+  test_bulk_insert<setGraph>();
+  test_bulk_insert<soaVectorGraph>();
+  test_bulk_insert<sortedVectorGraph>();
+  test_erase<vectorGraph>();
+  test_erase<setGraph>();
+  test_erase<soaVectorGraph>();
+  test_erase<sortedVectorGraph>();
+  test_sorted_adjacency<sortedVectorGraph>();
+  test_csr<vectorGraph>();
+  test_csr<setGraph>();
+  test_memory_usage<setGraph>();
+  test_memory_usage<heapGraph>();
+  test_memory_usage<vectorGraph>();
+  test_memory_usage<soaVectorGraph>();
+  test_memory_usage<sortedVectorGraph>();
+  test_reorder<setGraph>();
+  test_reorder<vectorGraph>();
+  test_generators<setGraph>();
+  test_generators<vectorGraph>();
+  test_concurrent_graph();
+  test_versioned_graph();
+  test_compressed<setGraph>();
+  test_binary<setGraph>();
+  test_text_loader<setGraph>();
+  test_binary<vectorGraph>();
+  test_direction_optimizing_bfs<setGraph>();
+  test_direction_optimizing_bfs<vectorGraph>();
+  test_parallel_bfs<setGraph>();
+  test_multi_source_bfs<setGraph>();
+  test_dynamic_bfs<setGraph>();
+  test_dynamic_bfs<vectorGraph>();
+  test_shortest_paths<setGraph>();
+  test_shortest_paths<vectorGraph>();
+  test_connected_components<setGraph>();
 }
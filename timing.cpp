@@ -1,147 +1,521 @@
 #include "graph.h"
 #include "graph_algorithms.h"
+#include "graph_benchmark.h"
+#include "graph_binary.h"
+#include "graph_compressed.h"
+#include "graph_concurrent.h"
 #include "graph_dumb_vector.h"
+#include "graph_dynamic_bfs.h"
+#include "graph_generators.h"
+#include "graph_parallel_algorithms.h"
+#include "graph_reorder.h"
+#include "graph_text_loader.h"
+#include "graph_versioned.h"
 
+#include <atomic>
 #include <chrono>
 #include <climits>
 #include <cmath>
+#include <cstdio>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
-#include <unordered_map>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <utility>
 using namespace std;
 using namespace chrono;
 
-/// @brief create a complete graph of size n
-template<typename graph_id>
-void initialize_complete_graph(graph_id& g, size_t n) {
-  // add vertices
-  for(size_t i = 0; i < n; ++i)
-    g.insert_vertex(i);
+///@brief Time functions of a graph
+template<typename graph_id, typename Initializer>
+void time_graph(Initializer i, size_t n) {
+  double seconds[num_benchmark_phases];
+  perf_reading readings[num_benchmark_phases];
+  perf_counters counters;
+  graph_footprint footprint;
+  time_phases<graph_id>(i, n, all_benchmark_phases, seconds, &counters, readings,
+      &footprint);
+  cout << "\tGraph Size: " << n
+    << "\tCreate: " << seconds[int(benchmark_phase::create)]
+    << "\tBFS: " << seconds[int(benchmark_phase::bfs)]
+    << "\tDFS: " << seconds[int(benchmark_phase::dfs)]
+    << "\tErase: " << seconds[int(benchmark_phase::erase)]
+    << "\tBytes/vertex: " << footprint.bytes_per_vertex()
+    << "\tBytes/edge: " << footprint.bytes_per_edge() << endl;
 
-  //add edges
+  //counters where perf_event_open allows, nothing otherwise
+  const char* names[] = {"Create", "BFS", "DFS", "Erase"};
+  for(int p = 0; p < num_benchmark_phases; ++p)
+    if(readings[p].any())
+      cout << "\t\t" << names[p] << "\t" << readings[p] << endl;
+}
 
-  typedef typename graph_id::const_vertex_iterator CVI;
+/// @brief Control timing of a single function
+/// @tparam Func Function type
+/// @param f Function taking a single size_t parameter
+/// @param graph_size Max vertex numbers of the graph
+/// @param name Name of function for nice output
+
+template<typename graphID, typename Func>
+void time_function(Func f, size_t graph_size, string name) {
+  cout << "Graph type: "<< name << endl;
+
+  for(size_t gs = 20; gs <= graph_size; gs += 20) 
+    time_graph<graphID, Func>(f, gs);
 
-  for(CVI vi1 = g.vertices_cbegin(); vi1 != g.vertices_cend(); ++vi1)
-    for(CVI vi2 = g.vertices_cbegin(); vi2 != g.vertices_cend(); ++vi2)
-      if((*vi1)->descriptor() != (*vi2)->descriptor())
-        g.insert_edge((*vi1)->descriptor(), (*vi2)->descriptor(), double(rand()) / RAND_MAX);
 }
 
-/// @brief create a mesh of size n
-template<typename graph_id>
-void initialize_mesh_graph(graph_id& g, size_t n) {
-  //make n a square number
-  size_t rootn = sqrt(n);
-  n = rootn*rootn;
+/// @brief Time parallel BFS and connected components on one graph with a
+///        doubling number of threads
+/// @param i Initializer that builds the graph
+/// @param n Size of the graph
+/// @param name Name of the graph type for nice output
+template<typename graph_id, typename Initializer>
+void time_parallel_bfs(Initializer i, size_t n, string name) {
+  cout << "Graph type: " << name << "\tGraph Size: " << n << endl;
+  graph_id g;
+  i(g, n);
+
+  typedef typename graph_id::vertex_descriptor vertex_descriptor;
+  vector<vertex_descriptor> parent_map;
+  high_resolution_clock::time_point serial_start = high_resolution_clock::now();
+  breadth_first_search(g, parent_map);
+  high_resolution_clock::time_point serial_stop = high_resolution_clock::now();
+  double serial = duration_cast<duration<double>>(serial_stop - serial_start).count();
+  cout << "\tSerial BFS: " << serial << endl;
+
+  size_t max_threads = max<size_t>(1, thread::hardware_concurrency());
+  for(size_t t = 1; ; t = min(2 * t, max_threads)) {
+    thread_pool pool(t);
+    high_resolution_clock::time_point bfs_start = high_resolution_clock::now();
+    parallel_breadth_first_search(g, parent_map, pool);
+    high_resolution_clock::time_point bfs_stop = high_resolution_clock::now();
+    double bfs = duration_cast<duration<double>>(bfs_stop - bfs_start).count();
+    high_resolution_clock::time_point cc_start = high_resolution_clock::now();
+    connected_components(g, parent_map, pool);
+    high_resolution_clock::time_point cc_stop = high_resolution_clock::now();
+    cout << "\tThreads: " << t << "\tBFS: " << bfs << "\tSpeedup: " << serial / bfs
+      << "\tCC: " << duration_cast<duration<double>>(cc_stop - cc_start).count() << endl;
+    if(t == max_threads)
+      break;
+  }
+}
+
+/// @brief Time Dijkstra and delta-stepping from vertex 0 of one graph
+/// @param i Initializer that builds the graph
+/// @param n Size of the graph
+/// @param name Name of the graph type for nice output
+template<typename graph_id, typename Initializer>
+void time_shortest_paths(Initializer i, size_t n, string name) {
+  cout << "Graph type: " << name << "\tGraph Size: " << n << endl;
+  graph_id g;
+  i(g, n);
 
-  // add vertices
-  for(size_t i = 0; i < n; ++i)
-    g.insert_vertex(i);
+  typedef typename graph_id::vertex_descriptor vertex_descriptor;
+  vector<vertex_descriptor> parent_map;
+  vector<double> distance_map;
+  high_resolution_clock::time_point dijkstra_start = high_resolution_clock::now();
+  dijkstra_shortest_paths(g, 0, parent_map, distance_map);
+  high_resolution_clock::time_point dijkstra_stop = high_resolution_clock::now();
+  cout << "\tDijkstra: " << duration_cast<duration<double>>(dijkstra_stop - dijkstra_start).count() << endl;
 
-  // add edges
-  for(size_t i = 0; i < n; ++i) {
-    size_t x = i + 1;
-    size_t y = i + rootn;
+  thread_pool pool;
+  double heuristic = default_delta(g);
+  for(double delta : {heuristic / 4, heuristic, heuristic * 4}) {
+    high_resolution_clock::time_point ds_start = high_resolution_clock::now();
+    delta_stepping_shortest_paths(g, 0, parent_map, distance_map, delta, pool);
+    high_resolution_clock::time_point ds_stop = high_resolution_clock::now();
+    cout << "\tThreads: " << pool.size() << "\tDelta: " << delta
+      << "\tDelta-stepping: " << duration_cast<duration<double>>(ds_stop - ds_start).count() << endl;
+  }
+}
 
-    if(x % rootn != 0)
-      g.insert_edge_undirected(i, x, double(rand()) / RAND_MAX);
+///@brief Compare BFS and adjacency size of a CSR and a compressed snapshot
+template<typename graph_id, typename Initializer>
+void time_compressed(Initializer i, size_t n, string name) {
+  cout << "Graph type: " << name << "\tGraph Size: " << n << endl;
+  graph_id g;
+  i(g, n);
+  graph_csr<int, double> csr(g);
+  graph_compressed<int, double> compressed(g);
+
+  typedef typename graph_id::vertex_descriptor vertex_descriptor;
+  vector<vertex_descriptor> parent_map;
+  high_resolution_clock::time_point csr_start = high_resolution_clock::now();
+  breadth_first_search(csr, parent_map);
+  high_resolution_clock::time_point csr_stop = high_resolution_clock::now();
+  cout << "\tCSR BFS: " << duration_cast<duration<double>>(csr_stop - csr_start).count()
+    << "\tAdjacency bytes/edge: " << sizeof(vertex_descriptor) << endl;
+
+  high_resolution_clock::time_point compressed_start = high_resolution_clock::now();
+  breadth_first_search(compressed, parent_map);
+  high_resolution_clock::time_point compressed_stop = high_resolution_clock::now();
+  cout << "\tCompressed BFS: " << duration_cast<duration<double>>(compressed_stop - compressed_start).count()
+    << "\tAdjacency bytes/edge: " << compressed.adjacency_bytes_per_edge()
+    << "\tTotal bytes/edge: " << compressed.bytes_per_edge() << endl;
 
-    if(y < n)
-      g.insert_edge_undirected(i, y, double(rand()) / RAND_MAX);
+  //decoding every list, one target per iterator increment and in blocks
+  size_t sum = 0;
+  high_resolution_clock::time_point iterator_start = high_resolution_clock::now();
+  for(auto vi = compressed.vertices_cbegin(); vi != compressed.vertices_cend(); ++vi)
+    for(auto ai = compressed.out_begin(*vi); ai != compressed.out_end(*vi); ++ai)
+      sum += *ai;
+  high_resolution_clock::time_point iterator_stop = high_resolution_clock::now();
+  high_resolution_clock::time_point block_start = high_resolution_clock::now();
+  for(auto vi = compressed.vertices_cbegin(); vi != compressed.vertices_cend(); ++vi)
+    compressed.for_each_target(*vi, [&](vertex_descriptor t) {sum -= t;});
+  high_resolution_clock::time_point block_stop = high_resolution_clock::now();
+  cout << "\tDecode all lists, iterator: "
+    << duration_cast<duration<double>>(iterator_stop - iterator_start).count()
+    << "\tBlocks (" << simd_scan_isa() << "): "
+    << duration_cast<duration<double>>(block_stop - block_start).count()
+    << (sum ? "\tMismatch" : "") << endl;
+}
+
+///@brief Time BFS and DFS on one graph with its descriptors scrambled, and
+///       after relabeling it in each vertex_order
+template<typename graph_id, typename Initializer>
+void time_reorder(Initializer i, size_t n, string name) {
+  cout << "Graph type: " << name << "\tGraph Size: " << n << endl;
+  graph_id built, scrambled;
+  i(built, n);
+  vector<size_t> permutation;
+  for(auto vi = built.vertices_cbegin(); vi != built.vertices_cend(); ++vi)
+    permutation.push_back((*vi)->descriptor());
+  for(size_t k = permutation.size(); k > 1; --k)
+    swap(permutation[k - 1], permutation[rand() % k]);
+  vertex_relabeling map;
+  relabel(built, permutation, scrambled, map);
+
+  typedef typename graph_id::vertex_descriptor vertex_descriptor;
+  vector<vertex_descriptor> parent_map;
+  auto traverse = [&](const graph_id& g, string label) {
+    high_resolution_clock::time_point bfs_start = high_resolution_clock::now();
+    breadth_first_search(g, parent_map);
+    high_resolution_clock::time_point bfs_stop = high_resolution_clock::now();
+    depth_first_search(g, parent_map);
+    high_resolution_clock::time_point dfs_stop = high_resolution_clock::now();
+    cout << "\t" << label
+      << "\tBFS: " << duration_cast<duration<double>>(bfs_stop - bfs_start).count()
+      << "\tDFS: " << duration_cast<duration<double>>(dfs_stop - bfs_stop).count() << endl;
+  };
+  traverse(scrambled, "Scrambled:");
+
+  const pair<vertex_order, string> orders[] = {
+    {vertex_order::reverse_cuthill_mckee, "RCM:      "},
+    {vertex_order::degree_descending,     "Degree:   "},
+    {vertex_order::bfs,                   "BFS order:"}};
+  for(auto& o : orders) {
+    graph_id reordered;
+    high_resolution_clock::time_point reorder_start = high_resolution_clock::now();
+    reorder(scrambled, o.first, reordered, map);
+    high_resolution_clock::time_point reorder_stop = high_resolution_clock::now();
+    cout << "\t" << o.second << "\tReorder: "
+      << duration_cast<duration<double>>(reorder_stop - reorder_start).count() << endl;
+    traverse(reordered, o.second);
   }
 }
 
-/// @brief create a mesh of size n
+///@brief Print the memory_usage() breakdown of one graph
+template<typename graph_id, typename Initializer>
+void time_memory(Initializer i, size_t n, string name) {
+  //same seed for every layout, so they hold the same graph
+  srand(0);
+  graph_id g;
+  i(g, n);
+  graph_memory_usage u = g.memory_usage();
+  cout << "\t" << name << "\tVertices: " << u.vertex_objects << "\tEdges: " << u.edge_objects
+    << "\tVertex index: " << u.vertex_index << "\tEdge index: " << u.edge_index
+    << "\tAdjacency: " << u.adjacency << "\tArena overhead: " << u.arena_overhead
+    << "\tTotal: " << u.total() << "\tBytes/vertex: " << u.bytes_per_vertex(g.num_vertices())
+    << "\tBytes/edge: " << u.bytes_per_edge(g.num_edges()) << endl;
+}
+
+///@brief Time emitting the edges of R-MAT, G(n, p) and mesh graphs with
+///       about 16 edges per vertex, serially and on a thread_pool, then
+///       inserting the R-MAT batch into a graph
+/// @param n Number of vertices
 template<typename graph_id>
-void initialize_random_graph(graph_id& g, size_t n) {
-  // add vertices
-  for(size_t i = 0; i < n; ++i)
-    g.insert_vertex(i);
-
-  // add edges for connectivity
-  for(size_t i=0; i < n - 1; ++i)
-    g.insert_edge_undirected(i, i+1, double(rand()) / RAND_MAX);
-
-  size_t num_edges = n*sqrt(n)/2;
-  for(size_t i=0; i < num_edges; ++i) {
-    size_t s = rand() % n;
-    size_t t = rand() % n;
-    if(s != t)
-      g.insert_edge_undirected(s, t, double(rand()) / RAND_MAX);
+void time_generators(size_t n) {
+  typedef typename graph_id::edge_value edge_value;
+  unsigned scale = 0;
+  while((size_t(2) << scale) <= n)
+    ++scale;
+  size_t rootn = sqrt(n);
+  thread_pool pool;
+
+  auto emit = [&](const string& name, thread_pool* p, vector<edge_value>& batch) {
+    batch.clear();
+    high_resolution_clock::time_point start = high_resolution_clock::now();
+    if(name == "R-MAT")
+      rmat_edges(batch, scale, size_t(16) << scale, 0, p);
+    else if(name == "G(n,p)")
+      gnp_edges(batch, n, n > 1 ? 16.0 / (n - 1) : 0.0, 0, p);
     else
-      --i;
+      mesh_edges(batch, rootn, 0, p);
+    high_resolution_clock::time_point stop = high_resolution_clock::now();
+    return duration_cast<duration<double>>(stop - start).count();
+  };
+
+  vector<edge_value> batch;
+  for(string name : {"R-MAT", "G(n,p)", "Mesh"}) {
+    double serial = emit(name, nullptr, batch);
+    double parallel = emit(name, &pool, batch);
+    cout << "Graph type: " << name << "\tEdges: " << batch.size()
+      << "\tSerial: " << serial << "\tThreads: " << pool.size() << "\tParallel: " << parallel
+      << "\tEdges/s: " << batch.size() / parallel << endl;
+  }
+
+  emit("R-MAT", &pool, batch);
+  graph_id g;
+  high_resolution_clock::time_point insert_start = high_resolution_clock::now();
+  insert_generated(g, size_t(1) << scale, batch);
+  high_resolution_clock::time_point insert_stop = high_resolution_clock::now();
+  cout << "\tR-MAT insert_edges: " << duration_cast<duration<double>>(insert_stop - insert_start).count()
+    << "\tDistinct edges: " << g.num_edges() << endl;
+}
+
+///@brief Insert the distinct edges of an R-MAT graph from a doubling number
+///       of threads, into a graph behind one mutex and into a
+///       concurrent_graph, and report the edges inserted per second
+/// @param n Number of vertices, rounded down to a power of two
+void time_concurrent_ingest(size_t n) {
+  typedef graph<int, double>::edge_value edge_value;
+  unsigned scale = 0;
+  while((size_t(2) << scale) <= n)
+    ++scale;
+  n = size_t(1) << scale;
+  vector<edge_value> batch;
+  rmat_edges(batch, scale, 16 * n, 0);
+  sort(batch.begin(), batch.end(), [](const edge_value& a, const edge_value& b) {
+    return a.first < b.first;
+  });
+  batch.erase(unique(batch.begin(), batch.end(), [](const edge_value& a, const edge_value& b) {
+    return a.first == b.first;
+  }), batch.end());
+  //insert in generation order rather than sorted by source
+  shuffle(batch.begin(), batch.end(), graph_rng(1));
+  cout << "Graph type: R-MAT\tGraph Size: " << n << "\tEdges: " << batch.size() << endl;
+
+  auto slice = [&](size_t tid, size_t threads, size_t& begin, size_t& end) {
+    begin = batch.size() * tid / threads;
+    end = batch.size() * (tid + 1) / threads;
+  };
+
+  size_t max_threads = max<size_t>(1, thread::hardware_concurrency());
+  for(size_t t = 1; ; t = min(2 * t, max_threads)) {
+    thread_pool pool(t);
+
+    graph<int, double> locked;
+    insert_numbered_vertices(locked, n);
+    mutex m;
+    high_resolution_clock::time_point locked_start = high_resolution_clock::now();
+    pool.run([&](size_t tid) {
+      size_t begin, end;
+      slice(tid, t, begin, end);
+      for(size_t i = begin; i < end; ++i) {
+        lock_guard<mutex> lock(m);
+        locked.insert_edge(batch[i].first.first, batch[i].first.second, batch[i].second);
+      }
+    });
+    high_resolution_clock::time_point locked_stop = high_resolution_clock::now();
+    double locked_seconds = duration_cast<duration<double>>(locked_stop - locked_start).count();
+
+    concurrent_graph<int, double> sharded;
+    insert_numbered_vertices(sharded, n);
+    high_resolution_clock::time_point sharded_start = high_resolution_clock::now();
+    pool.run([&](size_t tid) {
+      size_t begin, end;
+      slice(tid, t, begin, end);
+      for(size_t i = begin; i < end; ++i)
+        sharded.insert_edge(batch[i].first.first, batch[i].first.second, batch[i].second);
+    });
+    high_resolution_clock::time_point sharded_stop = high_resolution_clock::now();
+    double sharded_seconds = duration_cast<duration<double>>(sharded_stop - sharded_start).count();
+
+    cout << "\tThreads: " << t
+      << "\tOne mutex: " << locked_seconds << " (" << batch.size() / locked_seconds << " edges/s)"
+      << "\tSharded: " << sharded_seconds << " (" << batch.size() / sharded_seconds << " edges/s)"
+      << endl;
+    if(t == max_threads)
+      break;
   }
 }
 
-///@brief Time functions of a graph
+///@brief Time BFS on a graph, on a snapshot of a versioned_graph holding
+///       the same edges, and on fresh snapshots while a writer thread keeps
+///       erasing and reinserting edges, and the writer's commits per second
+/// @param i Initializer that builds the graph
+/// @param n Size of the graph
+/// @param name Name of the graph type for nice output
 template<typename graph_id, typename Initializer>
-void time_graph(Initializer i, size_t n) {
-  cout << "\tGraph Size: "<< n; 
-  high_resolution_clock::time_point create_start = high_resolution_clock::now();
-  //create graph, testing insertion
+void time_snapshots(Initializer i, size_t n, string name) {
+  cout << "Graph type: " << name << "\tGraph Size: " << n << endl;
   graph_id g;
   i(g, n);
-  high_resolution_clock::time_point create_stop = high_resolution_clock::now();
-  cout << "\tCreate: " << duration_cast<duration<double>>(create_stop - create_start).count();
+  versioned_graph<int, double> vg;
+  vector<int> props;
+  vector<typename graph_id::edge_value> edges;
+  for(auto vi = g.vertices_cbegin(); vi != g.vertices_cend(); ++vi)
+    props.push_back((*vi)->property());
+  for(auto ei = g.edges_cbegin(); ei != g.edges_cend(); ++ei)
+    edges.emplace_back((*ei)->descriptor(), (*ei)->property());
+  vg.insert_vertices(props.begin(), props.end());
+  vg.insert_edges(edges.begin(), edges.end());
 
-  high_resolution_clock::time_point bfs_start = high_resolution_clock::now();
-  //run BFS
-  typedef typename graph_id::vertex_descriptor vertex_descriptor;
-  unordered_map<vertex_descriptor, vertex_descriptor> parent_map;
+  vector<size_t> parent_map;
+  high_resolution_clock::time_point graph_start = high_resolution_clock::now();
   breadth_first_search(g, parent_map);
-  high_resolution_clock::time_point bfs_stop = high_resolution_clock::now();
-  cout << "\tBFS: " << duration_cast<duration<double>>(bfs_stop - bfs_start).count();
+  high_resolution_clock::time_point graph_stop = high_resolution_clock::now();
+  double quiet;
+  {
+    auto s = vg.take_snapshot();
+    high_resolution_clock::time_point snapshot_start = high_resolution_clock::now();
+    breadth_first_search(s, parent_map);
+    high_resolution_clock::time_point snapshot_stop = high_resolution_clock::now();
+    quiet = duration_cast<duration<double>>(snapshot_stop - snapshot_start).count();
+  }
+  cout << "\tGraph BFS: " << duration_cast<duration<double>>(graph_stop - graph_start).count()
+    << "\tSnapshot BFS: " << quiet << endl;
+  if(edges.empty())
+    return;
 
-  high_resolution_clock::time_point erase_start = high_resolution_clock::now();
-  
-  //run DFS
-  high_resolution_clock::time_point dfs_start = high_resolution_clock::now();
-  parent_map.clear();
-  depth_first_search(g, parent_map);
-  high_resolution_clock::time_point dfs_stop = high_resolution_clock::now();
-  cout << "\tDFS: " << duration_cast<duration<double>>(dfs_stop - dfs_start).count();
-  
-  //test erase operations
-  size_t quarter_edge = g.num_edges() / 4;
-  for(size_t i = 0; i < quarter_edge; ++i) {
-      typename graph_id::edge_iterator ei = g.find_edge(
-          make_pair(rand() % g.num_vertices(), rand() % g.num_vertices())
-          );
-      if(ei != g.edges_end())
-        g.erase_edge((*ei)->descriptor());
+  //the writer takes turns erasing and reinserting one edge per commit while
+  //the searches run for at least a fifth of a second
+  atomic<bool> reading(true);
+  size_t commits = 0;
+  high_resolution_clock::time_point write_start = high_resolution_clock::now();
+  thread writer([&] {
+    for(size_t k = 0; reading; ++k, ++commits) {
+      auto& e = edges[k / 2 % edges.size()];
+      if(k % 2 == 0)
+        vg.erase_edge(e.first);
       else
-        --i;
+        vg.insert_edge(e.first.first, e.first.second, e.second);
+    }
+  });
+  size_t searches = 0;
+  high_resolution_clock::time_point read_start = high_resolution_clock::now();
+  high_resolution_clock::time_point read_stop = read_start;
+  for(; searches < 10 || read_stop - read_start < milliseconds(200); ++searches) {
+    auto s = vg.take_snapshot();
+    breadth_first_search(s, parent_map);
+    read_stop = high_resolution_clock::now();
   }
-  size_t quarter_nodes = g.num_vertices() / 4;
-  for(size_t i = 0; i < quarter_nodes; ++i) {
-      typename graph_id::vertex_iterator vi = g.find_vertex(rand() % g.num_vertices());
-      if(vi != g.vertices_end())
-        g.erase_vertex((*vi)->descriptor());
-      else
-        --i;
+  reading = false;
+  writer.join();
+  high_resolution_clock::time_point write_stop = high_resolution_clock::now();
+  vg.reclaim();
+  cout << "\tSnapshot BFS while writing: "
+    << duration_cast<duration<double>>(read_stop - read_start).count() / searches
+    << "\tWriter commits/s: "
+    << commits / duration_cast<duration<double>>(write_stop - write_start).count()
+    << "\tUnreclaimed: " << vg.pending_reclamation() << endl;
+}
+
+///@brief Compare repairing the BFS tree from vertex 0 after each edge
+///       update with searching again from scratch. Every sampled edge is
+///       erased and then inserted back, so the graph ends as it started.
+template<typename graph_id, typename Initializer>
+void time_incremental_bfs(Initializer i, size_t n, string name) {
+  cout << "Graph type: " << name << "\tGraph Size: " << n << endl;
+  graph_id g;
+  i(g, n);
+
+  typedef typename graph_id::vertex_descriptor vertex_descriptor;
+  vector<vertex_descriptor> parent_map;
+  high_resolution_clock::time_point full_start = high_resolution_clock::now();
+  breadth_first_search(g, parent_map);
+  high_resolution_clock::time_point full_stop = high_resolution_clock::now();
+
+  dynamic_bfs<graph_id> bfs(g, 0);
+  vector<typename graph_id::edge_value> edges;
+  size_t stride = max<size_t>(1, g.num_edges() / 1000);
+  size_t k = 0;
+  for(auto ei = g.edges_cbegin(); ei != g.edges_cend(); ++ei, ++k)
+    if(k % stride == 0)
+      edges.emplace_back((*ei)->descriptor(), (*ei)->property());
+
+  cout << "\tFull BFS: " << duration_cast<duration<double>>(full_stop - full_start).count();
+  if(edges.empty()) {
+    cout << endl;
+    return;
   }
-  high_resolution_clock::time_point erase_stop = high_resolution_clock::now();
-  cout << "\tErase: " << duration_cast<duration<double>>(erase_stop - erase_start).count() << endl;
-  
+  size_t touched = 0;
+  high_resolution_clock::time_point update_start = high_resolution_clock::now();
+  for(auto& e : edges) {
+    bfs.erase_edge(e.first);
+    touched += bfs.last_update_size();
+    bfs.insert_edge(e.first.first, e.first.second, e.second);
+    touched += bfs.last_update_size();
+  }
+  high_resolution_clock::time_point update_stop = high_resolution_clock::now();
+  cout << "\tRepair per update: "
+    << duration_cast<duration<double>>(update_stop - update_start).count() / (2 * edges.size())
+    << "\tVertices per update: " << double(touched) / (2 * edges.size()) << endl;
 }
 
-/// @brief Control timing of a single function
-/// @tparam Func Function type
-/// @param f Function taking a single size_t parameter
-/// @param graph_size Max vertex numbers of the graph
-/// @param name Name of function for nice output
+///@brief Time loading a graph from the text format, from the binary format,
+///       and mapping the binary file for a BFS served straight from it
+template<typename graph_id, typename Initializer>
+void time_load(Initializer i, size_t n, string name) {
+  cout << "Graph type: " << name << "\tGraph Size: " << n << endl;
+  const char* text_path = "timing_graph.txt";
+  const char* binary_path = "timing_graph.bin";
+  {
+    graph_id g;
+    i(g, n);
+    ofstream os(text_path);
+    os << g;
+    if(!save_binary(g, binary_path)) {
+      cerr << "Cannot write " << binary_path << endl;
+      return;
+    }
+  }
 
-template<typename graphID, typename Func>
-void time_function(Func f, size_t graph_size, string name) {
-  cout << "Graph type: "<< name << endl;
+  typedef typename graph_id::vertex_descriptor vertex_descriptor;
+  high_resolution_clock::time_point text_start = high_resolution_clock::now();
+  {
+    graph_id g;
+    ifstream is(text_path);
+    is >> g;
+  }
+  high_resolution_clock::time_point text_stop = high_resolution_clock::now();
+  double text_seconds = duration_cast<duration<double>>(text_stop - text_start).count();
+  cout << "\tText load: " << text_seconds;
 
-  for(size_t gs = 20; gs <= graph_size; gs += 20) 
-    time_graph<graphID, Func>(f, gs);
+  thread_pool pool;
+  text_load_stats stats;
+  {
+    graph_id g;
+    load_text(g, text_path, pool, &stats);
+  }
+  cout << "\tParallel text load (" << pool.size() << " threads): " << stats.seconds()
+    << " (parse " << stats.parse_seconds << ", insert " << stats.insert_seconds << ")";
+
+  high_resolution_clock::time_point binary_start = high_resolution_clock::now();
+  {
+    graph_id g;
+    load_binary(g, binary_path);
+  }
+  high_resolution_clock::time_point binary_stop = high_resolution_clock::now();
+  cout << "\tBinary load: " << duration_cast<duration<double>>(binary_stop - binary_start).count();
 
+  high_resolution_clock::time_point mapped_start = high_resolution_clock::now();
+  {
+    graph_mapped<int, double> m(binary_path);
+    vector<vertex_descriptor> parent_map;
+    breadth_first_search(m, parent_map);
+  }
+  high_resolution_clock::time_point mapped_stop = high_resolution_clock::now();
+  cout << "\tMap + BFS: " << duration_cast<duration<double>>(mapped_stop - mapped_start).count() << endl;
+  cout << "\tText throughput: operator>> " << stats.bytes / 1e6 / text_seconds << " MB/s, "
+    << stats.edges / text_seconds << " edges/s; parallel " << stats.mb_per_second() << " MB/s, "
+    << stats.edges_per_second() << " edges/s" << endl;
+
+  remove(text_path);
+  remove(binary_path);
 }
 
 /// @brief Main function to time all your functions
@@ -160,7 +534,15 @@ int main(int argc, char** argv) {
   size_t   random_size = atoi(argv[3]);
   
   typedef graph<int, double> graph_set_type;
+  typedef graph<int, double, heap_arena> graph_heap_type;
   typedef graph_vector<int, double> graph_vector_type;
+  typedef graph_vector<int, double, vector_soa> graph_soa_vector_type;
+  typedef graph_vector<int, double, vector_sorted> graph_sorted_vector_type;
+#ifndef GRAPH_EDGE_SET
+  cout<<"Edge container: open-addressing hash set\n";
+#else
+  cout<<"Edge container: std::set\n";
+#endif
   cout<<"--------------\nSET GRAPH:\n--------------\n";
   time_function<graph_set_type>(initialize_complete_graph<graph_set_type>, complete_size, "Complete");
   time_function<graph_set_type>(    initialize_mesh_graph<graph_set_type>,     mesh_size,     "Mesh");
@@ -170,4 +552,62 @@ int main(int argc, char** argv) {
   time_function<graph_vector_type>(initialize_complete_graph<graph_vector_type>, complete_size, "Complete");
   time_function<graph_vector_type>(    initialize_mesh_graph<graph_vector_type>,     mesh_size,     "Mesh");
   time_function<graph_vector_type>(  initialize_random_graph<graph_vector_type>,   random_size,   "Random");
+
+  cout<<"\n\n--------------\nVECTOR GRAPH (STRUCTURE OF ARRAYS, " << simd_scan_isa() << " SCANS):\n--------------\n";
+  time_function<graph_soa_vector_type>(initialize_complete_graph<graph_soa_vector_type>, complete_size, "Complete");
+  time_function<graph_soa_vector_type>(    initialize_mesh_graph<graph_soa_vector_type>,     mesh_size,     "Mesh");
+  time_function<graph_soa_vector_type>(  initialize_random_graph<graph_soa_vector_type>,   random_size,   "Random");
+
+  cout<<"\n\n--------------\nVECTOR GRAPH (SORTED ADJACENCY, SWAP-AND-POP ERASE):\n--------------\n";
+  time_function<graph_sorted_vector_type>(initialize_complete_graph<graph_sorted_vector_type>, complete_size, "Complete");
+  time_function<graph_sorted_vector_type>(    initialize_mesh_graph<graph_sorted_vector_type>,     mesh_size,     "Mesh");
+  time_function<graph_sorted_vector_type>(  initialize_random_graph<graph_sorted_vector_type>,   random_size,   "Random");
+
+  cout<<"\n\n--------------\nMEMORY FOOTPRINT (BYTES):\n--------------\n";
+  cout << "Graph type: Mesh\tGraph Size: " << mesh_size << endl;
+  time_memory<graph_set_type>(              initialize_mesh_graph<graph_set_type>,           mesh_size, "Set:    ");
+  time_memory<graph_heap_type>(             initialize_mesh_graph<graph_heap_type>,          mesh_size, "Heap:   ");
+  time_memory<graph_vector_type>(           initialize_mesh_graph<graph_vector_type>,        mesh_size, "Vector: ");
+  time_memory<graph_soa_vector_type>(       initialize_mesh_graph<graph_soa_vector_type>,    mesh_size, "SoA:    ");
+  time_memory<graph_sorted_vector_type>(    initialize_mesh_graph<graph_sorted_vector_type>, mesh_size, "Sorted: ");
+  cout << "Graph type: Random\tGraph Size: " << random_size << endl;
+  time_memory<graph_set_type>(            initialize_random_graph<graph_set_type>,           random_size, "Set:    ");
+  time_memory<graph_heap_type>(           initialize_random_graph<graph_heap_type>,          random_size, "Heap:   ");
+  time_memory<graph_vector_type>(         initialize_random_graph<graph_vector_type>,        random_size, "Vector: ");
+  time_memory<graph_soa_vector_type>(     initialize_random_graph<graph_soa_vector_type>,    random_size, "SoA:    ");
+  time_memory<graph_sorted_vector_type>(  initialize_random_graph<graph_sorted_vector_type>, random_size, "Sorted: ");
+
+  cout<<"\n\n--------------\nPARALLEL SCALING (SET GRAPH):\n--------------\n";
+  time_parallel_bfs<graph_set_type>(    initialize_mesh_graph<graph_set_type>,     mesh_size,     "Mesh");
+  time_parallel_bfs<graph_set_type>(  initialize_random_graph<graph_set_type>,   random_size,   "Random");
+
+  cout<<"\n\n--------------\nSHORTEST PATHS (SET GRAPH):\n--------------\n";
+  time_shortest_paths<graph_set_type>(    initialize_mesh_graph<graph_set_type>,     mesh_size,     "Mesh");
+  time_shortest_paths<graph_set_type>(  initialize_random_graph<graph_set_type>,   random_size,   "Random");
+
+  cout<<"\n\n--------------\nLOADING (SET GRAPH):\n--------------\n";
+  time_load<graph_set_type>(    initialize_mesh_graph<graph_set_type>,     mesh_size,     "Mesh");
+  time_load<graph_set_type>(  initialize_random_graph<graph_set_type>,   random_size,   "Random");
+
+  cout<<"\n\n--------------\nCOMPRESSED ADJACENCY (SET GRAPH):\n--------------\n";
+  time_compressed<graph_set_type>(    initialize_mesh_graph<graph_set_type>,     mesh_size,     "Mesh");
+  time_compressed<graph_set_type>(  initialize_random_graph<graph_set_type>,   random_size,   "Random");
+
+  cout<<"\n\n--------------\nVERTEX REORDERING (SET GRAPH):\n--------------\n";
+  time_reorder<graph_set_type>(    initialize_mesh_graph<graph_set_type>,     mesh_size,     "Mesh");
+  time_reorder<graph_set_type>(  initialize_random_graph<graph_set_type>,   random_size,   "Random");
+
+  cout<<"\n\n--------------\nGRAPH GENERATORS (SET GRAPH):\n--------------\n";
+  time_generators<graph_set_type>(16 * mesh_size);
+
+  cout<<"\n\n--------------\nCONCURRENT INGEST:\n--------------\n";
+  time_concurrent_ingest(16 * mesh_size);
+
+  cout<<"\n\n--------------\nSNAPSHOT READS (VERSIONED GRAPH):\n--------------\n";
+  time_snapshots<graph_set_type>(    initialize_mesh_graph<graph_set_type>,     mesh_size,     "Mesh");
+  time_snapshots<graph_set_type>(  initialize_random_graph<graph_set_type>,   random_size,   "Random");
+
+  cout<<"\n\n--------------\nINCREMENTAL BFS (SET GRAPH):\n--------------\n";
+  time_incremental_bfs<graph_set_type>(    initialize_mesh_graph<graph_set_type>,     mesh_size,     "Mesh");
+  time_incremental_bfs<graph_set_type>(  initialize_random_graph<graph_set_type>,   random_size,   "Random");
 }